@@ -0,0 +1,105 @@
+// Discrete vs. continuous (swept-circle) collision.
+//
+// "tunneling" sends fast movers at a wall of standing mobs and counts how
+// many end up on the far side. "crowd cost" runs the usual enemy wave around
+// the party and reports the mean tick time, to show what leaving continuous
+// collision on for every mob costs.
+//
+// Usage: ccd_bench [moverSpeed] [enemyCount] [tickCount]
+
+#include "simulation.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const float DELTA_TIME = static_cast<float>(Simulation::TIMESTEP);
+
+// Returns how many of the movers got through the wall
+int runTunneling(CollisionMode mode, float moverSpeed, int& moverCount) {
+    EntityManager manager;
+    manager.setCollisionMode(mode);
+
+    // Wall of touching mobs along the Z axis at x = 0
+    const int wallLength = 80;
+    for (int i = 0; i < wallLength; ++i) {
+        auto mob = manager.spawn<EnemyEntity>();
+        mob->setPosition(glm::vec3(0.0f, 0.0f, (i - wallLength / 2) * 1.0f));
+    }
+
+    std::vector<std::shared_ptr<EnemyEntity>> movers;
+    for (float z = -30.0f; z <= 30.0f; z += 3.0f) {
+        auto mover = manager.spawn<EnemyEntity>();
+        mover->setPosition(glm::vec3(-5.0f, 0.0f, z));
+        mover->stats.setBase(Stat::MovementSpeed, moverSpeed);
+        mover->moveTo(glm::vec3(20.0f, 0.0f, z));
+        movers.push_back(mover);
+    }
+
+    for (int tick = 0; tick < 120; ++tick) {
+        manager.updateAll(DELTA_TIME);
+    }
+
+    int tunneled = 0;
+    for (const auto& mover : movers) {
+        if (mover->getPosition().x > 0.0f) tunneled++;
+    }
+    moverCount = static_cast<int>(movers.size());
+    return tunneled;
+}
+
+double runCrowd(CollisionMode mode, int enemyCount, int tickCount) {
+    Simulation simulation;
+    simulation.getEntityManager().setCollisionMode(mode);
+    simulation.getEntityManager().reserve(enemyCount + 3);
+    simulation.createParty();
+
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> angleDis(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> distanceDis(10.0f, 10.0f + std::sqrt(static_cast<float>(enemyCount)));
+    for (int i = 0; i < enemyCount; ++i) {
+        float angle = angleDis(gen);
+        float distance = distanceDis(gen);
+        simulation.spawnEnemy(glm::vec3(std::cos(angle) * distance, 0.0f, std::sin(angle) * distance));
+    }
+
+    auto start = Clock::now();
+    for (int tick = 0; tick < tickCount; ++tick) {
+        simulation.step(DELTA_TIME);
+    }
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    return elapsed.count() / tickCount;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    float moverSpeed = argc > 1 ? static_cast<float>(std::atof(argv[1])) : 180.0f;
+    int enemyCount = argc > 2 ? std::atoi(argv[2]) : 2000;
+    int tickCount = argc > 3 ? std::atoi(argv[3]) : 300;
+
+    std::cout << "Mover speed " << moverSpeed << " (" << moverSpeed * DELTA_TIME << " per tick), "
+              << enemyCount << " enemies, " << tickCount << " ticks" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    const CollisionMode modes[] = {CollisionMode::Discrete, CollisionMode::Continuous};
+    const char* names[] = {"discrete", "continuous"};
+    for (int i = 0; i < 2; ++i) {
+        int moverCount = 0;
+        int tunneled = runTunneling(modes[i], moverSpeed, moverCount);
+        double crowdMs = runCrowd(modes[i], enemyCount, tickCount);
+
+        std::cout << "  " << std::left << std::setw(11) << names[i] << std::right
+                  << " tunneled " << tunneled << "/" << moverCount
+                  << ", crowd " << crowdMs << " ms/tick" << std::endl;
+    }
+
+    return 0;
+}
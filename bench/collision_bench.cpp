@@ -0,0 +1,125 @@
+// Microbenchmark for the per-pair cost of the mob neighbor loops.
+//
+// "dynamic_pointer_cast" walks the entity list the way the collision loops
+// used to: one RTTI cast and one shared_ptr copy per pair. "kind tag" walks
+// the EntityStorage arrays and filters on the compact kind byte instead.
+//
+// Usage: collision_bench [entityCount] [repetitions]
+
+#include "entity.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Count overlapping pairs using RTTI on every neighbor (pre-kind-tag path)
+size_t countOverlapsWithCast(const EntityManager& manager) {
+    size_t overlaps = 0;
+    const auto& entities = manager.getEntities();
+
+    for (const auto& self : entities) {
+        auto selfMob = std::dynamic_pointer_cast<MobEntity>(self);
+        if (!selfMob) continue;
+
+        glm::vec3 selfPosition = selfMob->getPosition();
+        float selfRadius = selfMob->getRadius();
+
+        for (const auto& other : entities) {
+            if (other.get() == self.get()) continue;
+
+            auto otherMob = std::dynamic_pointer_cast<MobEntity>(other);
+            if (!otherMob || !otherMob->isActive()) continue;
+
+            glm::vec3 offset = otherMob->getPosition() - selfPosition;
+            float minDistance = selfRadius + otherMob->getRadius();
+            if (glm::dot(offset, offset) < minDistance * minDistance) {
+                overlaps++;
+            }
+        }
+    }
+
+    return overlaps;
+}
+
+// Count overlapping pairs by streaming the storage arrays and the kind tag
+size_t countOverlapsWithKindTag(const EntityManager& manager) {
+    size_t overlaps = 0;
+    const EntityStorage& storage = manager.getStorage();
+    const uint32_t count = storage.size();
+
+    for (uint32_t self = 0; self < count; ++self) {
+        if (!isMobKind(storage.kinds[self])) continue;
+
+        glm::vec3 selfPosition = storage.positions[self];
+        float selfRadius = storage.radii[self];
+
+        for (uint32_t other = 0; other < count; ++other) {
+            if (other == self) continue;
+            if (!isMobKind(storage.kinds[other]) || !storage.active[other]) continue;
+
+            glm::vec3 offset = storage.positions[other] - selfPosition;
+            float minDistance = selfRadius + storage.radii[other];
+            if (glm::dot(offset, offset) < minDistance * minDistance) {
+                overlaps++;
+            }
+        }
+    }
+
+    return overlaps;
+}
+
+template <typename Fn>
+double measureNanosecondsPerPair(Fn&& fn, const EntityManager& manager, int repetitions, size_t& overlaps) {
+    size_t pairs = manager.getEntities().size() * manager.getEntities().size();
+
+    auto start = Clock::now();
+    for (int i = 0; i < repetitions; ++i) {
+        overlaps = fn(manager);
+    }
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+
+    return elapsed.count() / (static_cast<double>(pairs) * repetitions);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int entityCount = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    EntityManager manager;
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> dis(-30.0f, 30.0f);
+
+    // Mostly mobs, plus some plain entities so the cast has something to reject
+    for (int i = 0; i < entityCount; ++i) {
+        std::shared_ptr<Entity> entity;
+        if (i % 10 == 0) {
+            entity = std::make_shared<Entity>();
+        } else if (i % 10 == 1) {
+            entity = std::make_shared<PlayerEntity>();
+        } else {
+            entity = std::make_shared<BasicShooterEnemy>();
+        }
+        entity->setPosition(glm::vec3(dis(gen), 0.0f, dis(gen)));
+        manager.addEntity(entity);
+    }
+
+    size_t castOverlaps = 0;
+    size_t tagOverlaps = 0;
+    double castNs = measureNanosecondsPerPair(countOverlapsWithCast, manager, repetitions, castOverlaps);
+    double tagNs = measureNanosecondsPerPair(countOverlapsWithKindTag, manager, repetitions, tagOverlaps);
+
+    std::cout << "Entities: " << entityCount << ", repetitions: " << repetitions << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  dynamic_pointer_cast: " << castNs << " ns/pair (" << castOverlaps << " overlaps)" << std::endl;
+    std::cout << "  kind tag:             " << tagNs << " ns/pair (" << tagOverlaps << " overlaps)" << std::endl;
+    std::cout << "  speedup:              " << (castNs / tagNs) << "x" << std::endl;
+
+    return castOverlaps == tagOverlaps ? 0 : 1;
+}
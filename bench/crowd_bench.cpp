@@ -0,0 +1,166 @@
+// Heuristic vs. reciprocal (ORCA) steering with two crowds walking through
+// each other.
+//
+// Two blocks of agents start facing each other across an open field and each
+// agent heads for the mirror of its start position, so the crowds meet head
+// on in the middle. Every agent steers with MobEntity::steerAlong every tick.
+// Reports time spent steering, overlapping pairs left after each tick (the
+// collisions avoidance failed to prevent), how much agents turn per tick
+// (oscillation) and how many reached their goal, and how fast.
+//
+// Usage: crowd_bench [agentCount] [tickCount]
+
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const float DELTA_TIME = static_cast<float>(Simulation::TIMESTEP);
+const float ARRIVAL_DISTANCE = 0.5f;
+
+double steeringSeconds = 0.0;
+
+// Walks straight for its goal, steering around everyone else
+struct CrowdAgent : public EnemyEntity {
+    glm::vec3 goal{0.0f};
+    glm::vec3 heading{0.0f};
+    double turning{0.0};   // Summed heading change, radians
+    uint32_t steps{0};     // Ticks spent walking
+    int arrivalTick{-1};
+    int tick{0};
+
+    void update(float deltaTime) override {
+        glm::vec3 toGoal = goal - getPosition();
+        toGoal.y = 0.0f;
+        float distance = glm::length(toGoal);
+        if (distance > ARRIVAL_DISTANCE) {
+            auto start = Clock::now();
+            glm::vec3 direction = steerAlong(toGoal / distance, 3.0f);
+            steeringSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+            float speed = glm::length(direction);
+            if (speed > 0.001f) {
+                glm::vec3 unit = direction / speed;
+                if (glm::length(heading) > 0.0f) {
+                    turning += std::acos(glm::clamp(glm::dot(unit, heading), -1.0f, 1.0f));
+                }
+                heading = unit;
+                steps++;
+            }
+            moveTo(getPosition() + direction * getMovementSpeed() * deltaTime);
+        } else {
+            if (arrivalTick < 0) arrivalTick = tick;
+            stop();
+        }
+        tick++;
+        MobEntity::update(deltaTime);
+    }
+};
+
+struct Result {
+    double steeringUsPerAgentTick;
+    double tickMs;
+    uint64_t overlaps;     // Overlapping pairs summed over all ticks
+    uint32_t worstOverlaps;
+    double turningPerTick; // Mean degrees per agent per walking tick
+    int arrived;
+    double arrivalSeconds; // Mean over the agents that arrived
+};
+
+Result run(SteeringMode mode, int agentCount, int tickCount) {
+    EntityManager manager;
+    manager.setSteeringMode(mode);
+    manager.setSleepEnabled(false);
+    manager.reserve(agentCount);
+
+    // Two blocks, rows of 20 agents a meter and a half apart, 30 meters between them
+    std::vector<std::shared_ptr<CrowdAgent>> agents;
+    const int rowLength = 20;
+    const float spacing = 1.5f;
+    for (int i = 0; i < agentCount; ++i) {
+        int side = i % 2;
+        int index = i / 2;
+        float x = (index % rowLength - rowLength / 2) * spacing;
+        float z = 15.0f + (index / rowLength) * spacing;
+        if (side == 1) z = -z;
+
+        auto agent = manager.spawn<CrowdAgent>();
+        agent->setPosition(glm::vec3(x, 0.0f, z));
+        agent->goal = glm::vec3(-x, 0.0f, -z);
+        agents.push_back(agent);
+    }
+
+    Result result{};
+    steeringSeconds = 0.0;
+    double tickSeconds = 0.0;
+    const std::vector<glm::vec3>& positions = manager.getStorage().positions;
+    const std::vector<float>& radii = manager.getStorage().radii;
+
+    for (int tick = 0; tick < tickCount; ++tick) {
+        auto start = Clock::now();
+        manager.updateAll(DELTA_TIME);
+        tickSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+        // Pairs still overlapping by more than a hair once the tick is done
+        uint32_t overlaps = 0;
+        for (size_t a = 0; a < positions.size(); ++a) {
+            for (size_t b = a + 1; b < positions.size(); ++b) {
+                float minDistance = (radii[a] + radii[b]) * 0.95f;
+                glm::vec3 offset = positions[a] - positions[b];
+                if (glm::dot(offset, offset) < minDistance * minDistance) overlaps++;
+            }
+        }
+        result.overlaps += overlaps;
+        result.worstOverlaps = std::max(result.worstOverlaps, overlaps);
+    }
+
+    double turning = 0.0;
+    uint64_t steps = 0;
+    double arrivalTicks = 0.0;
+    for (const auto& agent : agents) {
+        turning += agent->turning;
+        steps += agent->steps;
+        if (agent->arrivalTick >= 0) {
+            result.arrived++;
+            arrivalTicks += agent->arrivalTick;
+        }
+    }
+
+    result.steeringUsPerAgentTick = steeringSeconds * 1e6 / (static_cast<double>(agentCount) * tickCount);
+    result.tickMs = tickSeconds * 1e3 / tickCount;
+    result.turningPerTick = steps ? turning / steps * 57.29578 : 0.0;
+    result.arrivalSeconds = result.arrived ? arrivalTicks / result.arrived * DELTA_TIME : 0.0;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int agentCount = argc > 1 ? std::atoi(argv[1]) : 400;
+    int tickCount = argc > 2 ? std::atoi(argv[2]) : 2400;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Opposing crowds: " << agentCount << " agents, " << tickCount << " ticks" << std::endl;
+    std::cout << "Steering    steer us/agent  tick ms  overlaps (worst tick)  turn deg/tick    arrived  (mean s)"
+              << std::endl;
+
+    const SteeringMode modes[2] = {SteeringMode::Heuristic, SteeringMode::Reciprocal};
+    const char* names[2] = {"heuristic ", "reciprocal"};
+    for (int i = 0; i < 2; ++i) {
+        Result result = run(modes[i], agentCount, tickCount);
+        std::cout << names[i] << std::setw(16) << result.steeringUsPerAgentTick << std::setw(9) << result.tickMs
+                  << std::setw(11) << result.overlaps << " (" << std::setw(4) << result.worstOverlaps << ")"
+                  << std::setw(15) << result.turningPerTick << std::setw(7) << result.arrived << " / " << agentCount
+                  << "  (" << std::setprecision(1) << result.arrivalSeconds << ")" << std::setprecision(3)
+                  << std::endl;
+    }
+    return 0;
+}
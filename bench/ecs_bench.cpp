@@ -0,0 +1,119 @@
+// Mob movement through EntityManager vs. the archetype ECS.
+//
+// Builds the same crowd twice: as EnemyEntity objects in an EntityManager
+// (parallel update mode) and as Position/Motion/Body entities in an
+// ArchetypeWorld stepped by MobMovementSystem. Both get the same random
+// targets every few seconds and run the same ticks. Reports time per tick
+// and per mob for each, and exits non-zero if the final positions differ.
+//
+// Usage: ecs_bench [mobCount] [tickCount] [workerThreads]
+
+#include "mob_systems.h"
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const float DELTA_TIME = static_cast<float>(Simulation::TIMESTEP);
+const int RETARGET_TICKS = 180;
+const float MOB_SPACING = 2.0f; // Arena area per mob is about this squared
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int mobCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int tickCount = argc > 2 ? std::atoi(argv[2]) : 600;
+    int workerThreads = argc > 3 ? std::atoi(argv[3]) : -1;
+    if (workerThreads < 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerThreads = hardwareThreads > 1 ? static_cast<int>(hardwareThreads) - 1 : 0;
+    }
+
+    const float halfSize = std::sqrt(static_cast<float>(mobCount)) * MOB_SPACING * 0.5f;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> positionDis(-halfSize, halfSize);
+
+    EntityManager manager;
+    manager.setUpdateMode(UpdateMode::Parallel, static_cast<size_t>(workerThreads));
+    manager.setFlowFieldEnabled(false);
+    manager.setSleepEnabled(false);
+    manager.reserve(mobCount);
+
+    ArchetypeWorld world;
+    MobMovementSystem movement;
+    ThreadPool pool(static_cast<size_t>(workerThreads));
+
+    std::vector<std::shared_ptr<EnemyEntity>> mobs;
+    std::vector<EntityHandle> handles;
+    for (int i = 0; i < mobCount; ++i) {
+        glm::vec3 position(positionDis(gen), 0.0f, positionDis(gen));
+
+        auto mob = manager.spawn<EnemyEntity>();
+        mob->setPosition(position);
+        mobs.push_back(mob);
+
+        handles.push_back(world.create(PositionComponent{position},
+                                       MotionComponent{position, mob->getMovementSpeed(), 0},
+                                       BodyComponent{mob->getRadius(), EntityKind::Enemy}));
+    }
+
+    double managerSeconds = 0.0;
+    double worldSeconds = 0.0;
+    for (int tick = 0; tick < tickCount; ++tick) {
+        if (tick % RETARGET_TICKS == 0) {
+            for (int i = 0; i < mobCount; ++i) {
+                glm::vec3 target(positionDis(gen), 0.0f, positionDis(gen));
+                mobs[i]->moveTo(target);
+                MotionComponent* motion = world.get<MotionComponent>(handles[i]);
+                motion->target = target;
+                motion->moving = 1;
+            }
+        }
+
+        auto start = Clock::now();
+        manager.updateAll(DELTA_TIME);
+        managerSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+        start = Clock::now();
+        movement.update(world, DELTA_TIME, nullptr, &pool);
+        worldSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Both should have computed exactly the same crowd
+    int mismatches = 0;
+    float worstOffset = 0.0f;
+    for (int i = 0; i < mobCount; ++i) {
+        glm::vec3 offset = world.get<PositionComponent>(handles[i])->value - mobs[i]->getPosition();
+        float length = glm::length(offset);
+        if (length > 0.0f) mismatches++;
+        worstOffset = std::max(worstOffset, length);
+    }
+
+    const double managerMs = managerSeconds * 1e3 / tickCount;
+    const double worldMs = worldSeconds * 1e3 / tickCount;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Mob movement: " << mobCount << " mobs, " << tickCount << " ticks, " << (workerThreads + 1)
+              << " threads" << std::endl;
+    std::cout << "  EntityManager:  " << managerMs << " ms/tick (" << (managerMs * 1e6 / mobCount) << " ns/mob)"
+              << std::endl;
+    std::cout << "  ArchetypeWorld: " << worldMs << " ms/tick (" << (worldMs * 1e6 / mobCount) << " ns/mob), "
+              << world.getArchetypeCount() << " archetype(s)" << std::endl;
+    std::cout << "  speedup:        " << (managerMs / worldMs) << "x" << std::endl;
+
+    if (mismatches > 0) {
+        std::cout << "MISMATCH: " << mismatches << " mobs ended up elsewhere (worst by " << worstOffset << ")"
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
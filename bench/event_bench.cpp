@@ -0,0 +1,147 @@
+// Event publishing from worker threads: EventBus vs. one locked vector.
+//
+// Each round, a ThreadPool runs over a range of producers that each publish
+// a few damage events (keyed by producer index), then the events are
+// delivered to one subscriber in key order: through EventBus::dispatch, and
+// through a mutex-guarded shared vector that is sorted afterwards. Reports
+// publish and delivery time per event and exits non-zero if the two ever
+// deliver a different sequence.
+//
+// Usage: event_bench [producerCount] [eventsPerProducer] [rounds] [workerThreads]
+
+#include "event_bus.h"
+#include "game_events.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Keyed {
+    uint32_t order;
+    DamageEvent event;
+};
+
+// Order-sensitive digest of a delivered batch
+uint64_t mixBatch(uint64_t hash, const DamageEvent* events, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        hash = (hash ^ events[i].target.value) * 1099511628211ull;
+        hash = (hash ^ static_cast<uint64_t>(events[i].amount)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+DamageEvent makeEvent(size_t producer, int index) {
+    DamageEvent event;
+    event.source = EntityHandle(static_cast<uint32_t>(producer) + 1, 1);
+    event.target = EntityHandle(static_cast<uint32_t>(producer * 7 + index) % 4096 + 1, 1);
+    event.amount = static_cast<float>(index + 1);
+    event.healthLeft = 0.0f;
+    event.position = glm::vec3(0.0f);
+    return event;
+}
+
+double nanosecondsPer(double seconds, uint64_t count) {
+    return seconds * 1e9 / static_cast<double>(count);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int producerCount = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int eventsPerProducer = argc > 2 ? std::atoi(argv[2]) : 4;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 100;
+    int workerThreads = argc > 4 ? std::atoi(argv[4]) : -1;
+    if (workerThreads < 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerThreads = hardwareThreads > 1 ? static_cast<int>(hardwareThreads) - 1 : 0;
+    }
+
+    ThreadPool pool(static_cast<size_t>(workerThreads));
+    const uint64_t eventsPerRound = static_cast<uint64_t>(producerCount) * eventsPerProducer;
+
+    // EventBus
+    EventBus bus;
+    uint64_t busHash = 14695981039346656037ull;
+    bus.subscribe<DamageEvent>([&](const DamageEvent* events, size_t count) {
+        busHash = mixBatch(busHash, events, count);
+    });
+
+    double busPublish = 0.0;
+    double busDispatch = 0.0;
+    for (int round = 0; round < rounds; ++round) {
+        auto start = Clock::now();
+        pool.parallelFor(producerCount, 64, [&](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p) {
+                for (int i = 0; i < eventsPerProducer; ++i) {
+                    bus.publish(makeEvent(p, i), static_cast<uint32_t>(p));
+                }
+            }
+        });
+        auto published = Clock::now();
+        bus.dispatch();
+        busPublish += std::chrono::duration<double>(published - start).count();
+        busDispatch += std::chrono::duration<double>(Clock::now() - published).count();
+    }
+
+    // Locked shared vector
+    std::mutex mutex;
+    std::vector<Keyed> shared;
+    std::vector<DamageEvent> batch;
+    uint64_t lockedHash = 14695981039346656037ull;
+
+    double lockedPublish = 0.0;
+    double lockedDispatch = 0.0;
+    for (int round = 0; round < rounds; ++round) {
+        auto start = Clock::now();
+        pool.parallelFor(producerCount, 64, [&](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p) {
+                for (int i = 0; i < eventsPerProducer; ++i) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    shared.push_back({static_cast<uint32_t>(p), makeEvent(p, i)});
+                }
+            }
+        });
+        auto published = Clock::now();
+        // Same merge as EventBus: a stable sort on the key, skipped when already in order
+        auto byOrder = [](const Keyed& a, const Keyed& b) {
+            return a.order < b.order;
+        };
+        if (!std::is_sorted(shared.begin(), shared.end(), byOrder)) {
+            std::stable_sort(shared.begin(), shared.end(), byOrder);
+        }
+        batch.clear();
+        for (const Keyed& keyed : shared) batch.push_back(keyed.event);
+        lockedHash = mixBatch(lockedHash, batch.data(), batch.size());
+        shared.clear();
+        lockedDispatch += std::chrono::duration<double>(Clock::now() - published).count();
+        lockedPublish += std::chrono::duration<double>(published - start).count();
+    }
+
+    const uint64_t totalEvents = eventsPerRound * rounds;
+    const EventBus::Stats stats = bus.getStats();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Events: " << producerCount << " producers x " << eventsPerProducer << " events, " << rounds
+              << " rounds, " << (workerThreads + 1) << " threads" << std::endl;
+    std::cout << "                publish ns/event  deliver ns/event" << std::endl;
+    std::cout << "  EventBus      " << std::setw(16) << nanosecondsPer(busPublish, totalEvents) << std::setw(18)
+              << nanosecondsPer(busDispatch, totalEvents) << "   (" << stats.producers << " producer buffers)"
+              << std::endl;
+    std::cout << "  locked vector " << std::setw(16) << nanosecondsPer(lockedPublish, totalEvents) << std::setw(18)
+              << nanosecondsPer(lockedDispatch, totalEvents) << std::endl;
+
+    if (stats.dispatched != totalEvents || busHash != lockedHash) {
+        std::cout << "MISMATCH: EventBus delivered " << stats.dispatched << " of " << totalEvents
+                  << " events or in a different order" << std::endl;
+        return 1;
+    }
+    return 0;
+}
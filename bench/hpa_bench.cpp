@@ -0,0 +1,189 @@
+// Flat A* vs. hierarchical (HPA*) path queries on a large map.
+//
+// Generates a mapSize x mapSize grid of walled rooms joined by doorways and
+// scattered with pillars, then runs the same random queries through a flat
+// PathService and a hierarchical one. Reports time and expanded nodes per
+// query, grouped by how many clusters the query spans, plus path length
+// relative to flat A*, the cost of refining a corridor, and the cost of
+// rebuilding the hierarchy after a wall changes.
+//
+// Usage: hpa_bench [mapSize] [queryCount]
+
+#include "path_service.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int32_t ROOM_SIZE = 32;
+const int32_t DOOR_WIDTH = 3;
+
+void buildRooms(NavGrid& grid, std::mt19937& gen) {
+    const int32_t size = grid.getWidth();
+    std::uniform_int_distribution<int32_t> doorDis(2, ROOM_SIZE - DOOR_WIDTH - 2);
+    std::uniform_real_distribution<float> pillarDis(0.0f, 1.0f);
+
+    for (int32_t z = 0; z < size; ++z) {
+        for (int32_t x = 0; x < size; ++x) {
+            if (pillarDis(gen) < 0.04f) {
+                grid.setBlocked(grid.cellIndex(x, z), true);
+            }
+        }
+    }
+
+    // Room walls along every ROOM_SIZE-th row and column, two doorways per wall
+    for (int32_t line = ROOM_SIZE; line < size; line += ROOM_SIZE) {
+        for (int32_t room = 0; room < size; room += ROOM_SIZE) {
+            int32_t doors[2] = {room + doorDis(gen), room + doorDis(gen)};
+            for (int32_t i = room; i < room + ROOM_SIZE && i < size; ++i) {
+                bool door = (i >= doors[0] && i < doors[0] + DOOR_WIDTH) || (i >= doors[1] && i < doors[1] + DOOR_WIDTH);
+                grid.setBlocked(grid.cellIndex(line, i), !door);
+                grid.setBlocked(grid.cellIndex(i, line), !door);
+            }
+        }
+    }
+}
+
+float pathLength(const std::vector<glm::vec3>& waypoints, const glm::vec3& start) {
+    float length = 0.0f;
+    glm::vec3 previous = start;
+    for (const glm::vec3& waypoint : waypoints) {
+        length += glm::length(waypoint - previous);
+        previous = waypoint;
+    }
+    return length;
+}
+
+struct Bucket {
+    uint32_t queries = 0;
+    double flatUs = 0.0;
+    double hierarchicalUs = 0.0;
+    uint64_t flatExpanded = 0;
+    uint64_t hierarchicalExpanded = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int32_t mapSize = argc > 1 ? std::atoi(argv[1]) : 512;
+    int queryCount = argc > 2 ? std::atoi(argv[2]) : 300;
+
+    NavGrid grid(1.0f, mapSize, mapSize);
+    std::mt19937 gen(99);
+    buildRooms(grid, gen);
+
+    PathService flat(grid);
+    flat.setHierarchical(false);
+
+    PathService hierarchical(grid);
+    auto buildStart = Clock::now();
+    hierarchical.invalidate(grid.getChangedCells());
+    std::chrono::duration<double, std::milli> buildMs = Clock::now() - buildStart;
+    grid.clearChangedCells();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Map " << mapSize << "x" << mapSize << ", " << hierarchical.getHierarchy().getClusterCount()
+              << " clusters, " << hierarchical.getHierarchy().getNodeCount() << " nodes, built in " << buildMs.count()
+              << " ms" << std::endl;
+
+    // Random open start/goal pairs; every query is a cache miss
+    std::uniform_int_distribution<int32_t> cellDis(0, grid.getCellCount() - 1);
+    const int32_t bucketSpan = 4; // Clusters per bucket of query distance
+    std::vector<Bucket> buckets;
+    double flatLength = 0.0;
+    double hierarchicalLength = 0.0;
+    double refineUs = 0.0;
+    uint64_t segments = 0;
+    int found = 0;
+
+    for (int q = 0; q < queryCount; ++q) {
+        int32_t startCell, goalCell;
+        do {
+            startCell = cellDis(gen);
+        } while (grid.isBlocked(startCell));
+        do {
+            goalCell = cellDis(gen);
+        } while (grid.isBlocked(goalCell));
+        glm::vec3 start = grid.cellCenter(startCell);
+        glm::vec3 goal = grid.cellCenter(goalCell);
+
+        PathService::Stats flatBefore = flat.getStats();
+        auto flatStart = Clock::now();
+        auto flatPath = flat.findPath(start, goal);
+        std::chrono::duration<double, std::micro> flatElapsed = Clock::now() - flatStart;
+
+        PathService::Stats hierarchicalBefore = hierarchical.getStats();
+        auto hierarchicalStart = Clock::now();
+        auto hierarchicalPath = hierarchical.findPath(start, goal);
+        std::chrono::duration<double, std::micro> hierarchicalElapsed = Clock::now() - hierarchicalStart;
+
+        size_t bucket = hierarchical.getHierarchy().clusterDistance(startCell, goalCell) / bucketSpan;
+        if (bucket >= buckets.size()) buckets.resize(bucket + 1);
+        buckets[bucket].queries++;
+        buckets[bucket].flatUs += flatElapsed.count();
+        buckets[bucket].hierarchicalUs += hierarchicalElapsed.count();
+        buckets[bucket].flatExpanded += flat.getStats().expandedNodes - flatBefore.expandedNodes;
+        buckets[bucket].hierarchicalExpanded += hierarchical.getStats().expandedNodes - hierarchicalBefore.expandedNodes;
+
+        // Compare lengths only where flat A* finished within its expansion cap
+        if (!flatPath->found() || !hierarchicalPath->found()) continue;
+        found++;
+
+        std::vector<glm::vec3> flatWaypoints;
+        flat.refineSegment(*flatPath, 0, flatWaypoints);
+        flatLength += pathLength(flatWaypoints, start);
+
+        std::vector<glm::vec3> waypoints;
+        auto refineStart = Clock::now();
+        for (size_t segment = 0; segment < hierarchicalPath->getSegmentCount(); ++segment) {
+            hierarchical.refineSegment(*hierarchicalPath, segment, waypoints);
+        }
+        std::chrono::duration<double, std::micro> refineElapsed = Clock::now() - refineStart;
+        refineUs += refineElapsed.count();
+        segments += hierarchicalPath->getSegmentCount();
+        hierarchicalLength += pathLength(waypoints, start);
+    }
+
+    std::cout << "Clusters apart   queries   flat us  flat nodes   HPA* us  HPA* nodes" << std::endl;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        const Bucket& b = buckets[i];
+        if (b.queries == 0) continue;
+        std::cout << "  " << std::setw(3) << i * bucketSpan << "-" << std::setw(3) << (i + 1) * bucketSpan - 1
+                  << std::setw(12) << b.queries << std::setprecision(1) << std::setw(10) << b.flatUs / b.queries
+                  << std::setw(12) << static_cast<double>(b.flatExpanded) / b.queries << std::setw(10)
+                  << b.hierarchicalUs / b.queries << std::setw(12)
+                  << static_cast<double>(b.hierarchicalExpanded) / b.queries << std::setprecision(3) << std::endl;
+    }
+
+    std::cout << "  paths found by both: " << found << " / " << queryCount << std::endl;
+    if (found > 0) {
+        std::cout << "  HPA* path length:    " << (hierarchicalLength / flatLength) << " x flat" << std::endl;
+        std::cout << "  refinement:          " << (refineUs / segments) << " us/segment, "
+                  << (static_cast<double>(segments) / found) << " segments/path" << std::endl;
+    }
+
+    // Close a doorway and reopen it: only the touched clusters are rebuilt
+    int32_t door = -1;
+    for (int32_t i = ROOM_SIZE; i < mapSize && door < 0; ++i) {
+        int32_t cell = grid.cellIndex(ROOM_SIZE, i);
+        if (!grid.isBlocked(cell)) door = cell;
+    }
+    if (door >= 0) {
+        auto updateStart = Clock::now();
+        grid.setBlocked(door, true);
+        hierarchical.invalidate(grid.getChangedCells());
+        grid.clearChangedCells();
+        grid.setBlocked(door, false);
+        hierarchical.invalidate(grid.getChangedCells());
+        grid.clearChangedCells();
+        std::chrono::duration<double, std::milli> updateMs = Clock::now() - updateStart;
+        std::cout << "  wall change:         " << (updateMs.count() / 2.0) << " ms per rebuild" << std::endl;
+    }
+    return 0;
+}
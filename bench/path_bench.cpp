@@ -0,0 +1,203 @@
+// Grid A* and path cache benchmark.
+//
+// Builds a walled arena: the party stands inside a box open only on its far
+// side, enemies start behind the closed side, and a field of pillars sits
+// between them. First times raw A* queries from scattered cells toward the
+// party, cold and with the cache warm. Then runs the simulation so enemies
+// route around the walls, toggling a gate across the box's opening to
+// exercise cache invalidation, and reports cache hit rate, expanded nodes per
+// query and how many enemies reached the party. Enemies request their paths
+// asynchronously; the worst tick shows what the per-tick commit cap bounds.
+// Finally reruns the chase with a small commit cap (so searches run ticks
+// ahead of their commit, across gate changes) on 0, 1 and 4 path workers and
+// exits non-zero if the final positions differ.
+//
+// Usage: path_bench [enemyCount] [tickCount] [queryCount] [commitsPerTick]
+
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void buildArena(NavGrid& grid) {
+    // Box around the origin, open toward +Z
+    grid.setBlockedRect(glm::vec3(-8.0f, 0.0f, -8.0f), glm::vec3(8.0f, 0.0f, -8.0f), true);
+    grid.setBlockedRect(glm::vec3(-8.0f, 0.0f, -8.0f), glm::vec3(-8.0f, 0.0f, 6.0f), true);
+    grid.setBlockedRect(glm::vec3(8.0f, 0.0f, -8.0f), glm::vec3(8.0f, 0.0f, 6.0f), true);
+
+    // Pillars between the box and where the enemies start
+    for (int z = -30; z <= -14; z += 4) {
+        for (int x = -30; x <= 30; x += 4) {
+            grid.setBlockedRect(glm::vec3(x, 0.0f, z), glm::vec3(x + 1.0f, 0.0f, z + 1.0f), true);
+        }
+    }
+}
+
+const glm::vec3 GATE(0.0f, 0.0f, 6.0f);
+const uint32_t DETERMINISM_COMMITS_PER_TICK = 2;
+
+void setUpChase(Simulation& simulation, int enemyCount, uint32_t commitsPerTick) {
+    EntityManager& manager = simulation.getEntityManager();
+    buildArena(manager.getNavGrid());
+    manager.getPathJobs().setCommitsPerTick(commitsPerTick);
+    simulation.createParty();
+
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> xDis(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> zDis(-45.0f, -33.0f);
+    for (int i = 0; i < enemyCount; ++i) {
+        float x = xDis(gen);
+        float z = zDis(gen);
+        simulation.spawnEnemy(glm::vec3(x, 0.0f, z));
+    }
+}
+
+void stepChase(Simulation& simulation, int tick) {
+    // A gate across half of the box's opening closes and opens every two seconds
+    if (tick % 120 == 60) {
+        simulation.getEntityManager().getNavGrid().setBlockedRect(GATE, GATE + glm::vec3(7.0f, 0.0f, 0.0f),
+                                                                  tick % 240 == 60);
+    }
+    simulation.step(static_cast<float>(Simulation::TIMESTEP));
+}
+
+// FNV-1a over every entity's final position
+uint32_t hashPositions(const EntityManager& manager) {
+    uint32_t hash = 2166136261u;
+    for (const auto& entity : manager.getEntities()) {
+        glm::vec3 position = entity->getPosition();
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&position);
+        for (size_t i = 0; i < sizeof(position); ++i) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+void printStats(const PathService::Stats& stats) {
+    std::cout << "  queries:         " << stats.queries << " (" << stats.searches << " searched)" << std::endl;
+    std::cout << "  cache hit rate:  " << (stats.hitRate() * 100.0) << " %" << std::endl;
+    std::cout << "  expanded/query:  " << stats.expandedPerQuery() << " (" << stats.expandedPerSearch()
+              << " per search)" << std::endl;
+    std::cout << "  invalidated:     " << stats.invalidated << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int enemyCount = argc > 1 ? std::atoi(argv[1]) : 500;
+    int tickCount = argc > 2 ? std::atoi(argv[2]) : 2400;
+    int queryCount = argc > 3 ? std::atoi(argv[3]) : 2000;
+    uint32_t commitsPerTick = argc > 4 ? static_cast<uint32_t>(std::atoi(argv[4])) : PathJobQueue::DEFAULT_COMMITS_PER_TICK;
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    // Raw queries: scattered starts toward the party's cells
+    {
+        NavGrid grid;
+        buildArena(grid);
+        PathService service(grid);
+        service.invalidate(grid.getChangedCells());
+        grid.clearChangedCells();
+
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<float> dis(-50.0f, 50.0f);
+        std::vector<glm::vec3> starts;
+        for (int i = 0; i < queryCount; ++i) {
+            float x = dis(gen);
+            float z = dis(gen);
+            starts.push_back(glm::vec3(x, 0.0f, z));
+        }
+        const glm::vec3 goals[3] = {glm::vec3(0.0f), glm::vec3(2.0f, 0.0f, 0.0f), glm::vec3(-2.0f, 0.0f, 0.0f)};
+
+        size_t found = 0;
+        for (int pass = 0; pass < 2; ++pass) {
+            auto start = Clock::now();
+            for (int i = 0; i < queryCount; ++i) {
+                auto path = service.findPath(starts[i], goals[i % 3]);
+                if (pass == 0 && path && path->found()) found++;
+            }
+            std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+            std::cout << (pass == 0 ? "Cold" : "Warm") << " queries: " << (elapsed.count() / queryCount)
+                      << " us/query" << std::endl;
+        }
+        std::cout << "  paths found:     " << found << " / " << queryCount << std::endl;
+        printStats(service.getStats());
+    }
+
+    // Enemies chasing the party around the walls
+    Simulation simulation(UpdateMode::Parallel, 0, 1);
+    EntityManager& manager = simulation.getEntityManager();
+    setUpChase(simulation, enemyCount, commitsPerTick);
+
+    double totalMs = 0.0;
+    double worstMs = 0.0;
+    for (int tick = 0; tick < tickCount; ++tick) {
+        auto tickStart = Clock::now();
+        stepChase(simulation, tick);
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - tickStart;
+        totalMs += elapsed.count();
+        worstMs = std::max(worstMs, elapsed.count());
+    }
+
+    // Enemies that made it into the box with the party
+    size_t reached = 0;
+    for (const auto& entity : manager.getEntities()) {
+        glm::vec3 position = entity->getPosition();
+        if (entity->getKind() == EntityKind::Enemy && std::abs(position.x) < 8.0f && position.z > -8.0f &&
+            position.z < 6.0f) {
+            reached++;
+        }
+    }
+
+    std::cout << "Simulation: " << enemyCount << " enemies, " << tickCount << " ticks" << std::endl;
+    std::cout << "  tick mean:       " << (totalMs / tickCount) << " ms (max " << worstMs << " ms)" << std::endl;
+    std::cout << "  reached party:   " << reached << " / " << enemyCount << std::endl;
+    std::cout << "  cached paths:    " << manager.getPathService().getCacheSize() << std::endl;
+    printStats(manager.getPathService().getStats());
+
+    const PathJobQueue::Stats jobs = manager.getPathJobs().getStats();
+    std::cout << "Path jobs: " << manager.getPathJobs().getCommitsPerTick() << " commits per tick" << std::endl;
+    std::cout << "  requested:       " << jobs.requested << " (" << jobs.replaced << " replaced)" << std::endl;
+    std::cout << "  committed:       " << jobs.committed << std::endl;
+    std::cout << "  commit waits:    " << jobs.waits << std::endl;
+    std::cout << "  re-searched:     " << jobs.researched << " (grid changed before commit)" << std::endl;
+    std::cout << "  max backlog:     " << jobs.maxBacklog << std::endl;
+
+    // Committed paths must not depend on how far ahead the workers got
+    std::cout << "Determinism: " << DETERMINISM_COMMITS_PER_TICK << " commits per tick" << std::endl;
+    std::cout << std::hex;
+    uint32_t expected = 0;
+    bool mismatch = false;
+    for (size_t workers : {0, 1, 4}) {
+        Simulation rerun(UpdateMode::Parallel, 0, 1);
+        rerun.getEntityManager().getPathJobs().setWorkerCount(workers);
+        setUpChase(rerun, enemyCount, DETERMINISM_COMMITS_PER_TICK);
+        for (int tick = 0; tick < tickCount; ++tick) {
+            stepChase(rerun, tick);
+        }
+
+        uint32_t hash = hashPositions(rerun.getEntityManager());
+        std::cout << "  " << workers << " path workers:  " << hash << std::endl;
+        if (workers == 0) {
+            expected = hash;
+        } else if (hash != expected) {
+            mismatch = true;
+        }
+    }
+
+    if (mismatch) {
+        std::cout << "MISMATCH: final positions depend on the path worker count" << std::endl;
+        return 1;
+    }
+    return 0;
+}
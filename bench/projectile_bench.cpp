@@ -0,0 +1,110 @@
+// Bullet-hell projectile throughput on one core.
+//
+// Scatters mobs over an arena and keeps a target number of projectiles live,
+// refilling whatever expired or hit something each tick. Times
+// ProjectileSystem::update alone (queued shots, integration, broadphase hit
+// tests and retirement) against the 60 Hz frame budget.
+//
+// Usage: projectile_bench [liveCount] [mobCount] [tickCount]
+
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const float DELTA_TIME = static_cast<float>(Simulation::TIMESTEP);
+const float ARENA_HALF_SIZE = 60.0f;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int liveCount = argc > 1 ? std::atoi(argv[1]) : 50000;
+    int mobCount = argc > 2 ? std::atoi(argv[2]) : 2000;
+    int tickCount = argc > 3 ? std::atoi(argv[3]) : 600;
+
+    // Standing mobs: a few PCs among the enemies so both sides get hit
+    EntityManager manager;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> positionDis(-ARENA_HALF_SIZE, ARENA_HALF_SIZE);
+    for (int i = 0; i < mobCount; ++i) {
+        std::shared_ptr<MobEntity> mob;
+        if (i % 100 == 0) {
+            mob = manager.spawn<PlayerEntity>();
+        } else {
+            mob = manager.spawn<EnemyEntity>();
+        }
+        float x = positionDis(gen);
+        float z = positionDis(gen);
+        mob->setPosition(glm::vec3(x, 0.0f, z));
+    }
+
+    SpatialHashGrid grid;
+    grid.rebuild(manager.getStorage());
+
+    ProjectileSystem projectiles(static_cast<size_t>(liveCount) + 1024);
+    std::uniform_real_distribution<float> angleDis(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> speedDis(6.0f, 18.0f);
+    std::uniform_real_distribution<float> lifetimeDis(1.0f, 4.0f);
+    auto refill = [&]() {
+        for (size_t i = projectiles.getCount(); i < static_cast<size_t>(liveCount); ++i) {
+            float angle = angleDis(gen);
+            float speed = speedDis(gen);
+            ProjectileSystem::Shot shot;
+            float x = positionDis(gen);
+            float z = positionDis(gen);
+            shot.position = glm::vec3(x, 0.5f, z);
+            shot.velocity = glm::vec3(std::cos(angle) * speed, 0.0f, std::sin(angle) * speed);
+            shot.lifetime = lifetimeDis(gen);
+            shot.radius = 0.1f;
+            shot.damage = 1.0f;
+            shot.owner = EntityHandle();
+            shot.ownerKind = i % 2 ? EntityKind::Enemy : EntityKind::Player;
+            projectiles.fire(shot, 0);
+        }
+    };
+
+    std::vector<ProjectileSystem::Hit> hits;
+    hits.reserve(liveCount);
+    std::vector<double> tickMs;
+    tickMs.reserve(tickCount);
+    uint64_t projectileTicks = 0;
+
+    refill();
+    projectiles.update(DELTA_TIME, grid, manager.getStorage(), nullptr, hits); // Warm up
+    for (int tick = 0; tick < tickCount; ++tick) {
+        refill();
+        hits.clear();
+
+        auto start = Clock::now();
+        projectiles.update(DELTA_TIME, grid, manager.getStorage(), nullptr, hits);
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+        tickMs.push_back(elapsed.count());
+        projectileTicks += projectiles.getCount();
+    }
+
+    std::sort(tickMs.begin(), tickMs.end());
+    double total = 0.0;
+    for (double ms : tickMs) total += ms;
+    const double mean = total / tickCount;
+    const double budgetMs = DELTA_TIME * 1000.0;
+    const ProjectileSystem::Stats stats = projectiles.getStats();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Projectiles: " << liveCount << " live, " << mobCount << " mobs, " << tickCount << " ticks" << std::endl;
+    std::cout << "  update mean:     " << mean << " ms (p99 " << tickMs[tickCount * 99 / 100] << " ms, "
+              << (mean / budgetMs * 100.0) << " % of a 60 Hz frame)" << std::endl;
+    std::cout << "  per projectile:  " << (total * 1e6 / projectileTicks) << " ns" << std::endl;
+    std::cout << "  hits:            " << stats.hits << " (" << (static_cast<double>(stats.hits) / tickCount)
+              << " per tick)" << std::endl;
+    std::cout << "  expired:         " << stats.expired << ", dropped: " << stats.dropped << std::endl;
+    return 0;
+}
@@ -0,0 +1,248 @@
+// Spatial query benchmark and cross-check.
+//
+// Scatters mobs (a few PCs among many enemies) over an arena and runs the
+// same random radius, k-nearest, box and ray queries through EntityManager
+// and as plain linear scans over the storage arrays. Reports the time per
+// query for both and exits non-zero if the grid answer ever differs from
+// the scan.
+//
+// Usage: query_bench [mobCount] [queryCount]
+
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const float ARENA_HALF_SIZE = 100.0f;
+const float QUERY_RADIUS = 6.0f;
+const size_t NEAREST_COUNT = 8;
+const float BOX_HALF_SIZE = 5.0f;
+const float RAY_LENGTH = 40.0f;
+
+struct Query {
+    glm::vec3 position;
+    glm::vec3 direction;
+    EntityKindMask kinds;
+};
+
+bool accepts(const EntityStorage& storage, uint32_t slot, EntityKindMask kinds) {
+    return storage.active[slot] && isMobKind(storage.kinds[slot]) && (kinds & kindMask(storage.kinds[slot]));
+}
+
+void scanRadius(const EntityStorage& storage, const Query& query, std::vector<uint32_t>& results) {
+    results.clear();
+    for (uint32_t slot = 0; slot < storage.size(); ++slot) {
+        if (!accepts(storage, slot, query.kinds)) continue;
+        glm::vec3 offset = storage.positions[slot] - query.position;
+        if (glm::dot(offset, offset) <= QUERY_RADIUS * QUERY_RADIUS) results.push_back(slot);
+    }
+}
+
+void scanKNearest(const EntityStorage& storage, const Query& query, std::vector<std::pair<float, uint32_t>>& scratch,
+                  std::vector<uint32_t>& results) {
+    scratch.clear();
+    for (uint32_t slot = 0; slot < storage.size(); ++slot) {
+        if (!accepts(storage, slot, query.kinds)) continue;
+        glm::vec3 offset = storage.positions[slot] - query.position;
+        scratch.push_back({glm::dot(offset, offset), slot});
+    }
+    size_t count = std::min(scratch.size(), NEAREST_COUNT);
+    std::partial_sort(scratch.begin(), scratch.begin() + count, scratch.end());
+    results.clear();
+    for (size_t i = 0; i < count; ++i) results.push_back(scratch[i].second);
+}
+
+void scanAABB(const EntityStorage& storage, const Query& query, std::vector<uint32_t>& results) {
+    results.clear();
+    for (uint32_t slot = 0; slot < storage.size(); ++slot) {
+        if (!accepts(storage, slot, query.kinds)) continue;
+        const glm::vec3& p = storage.positions[slot];
+        if (std::fabs(p.x - query.position.x) <= BOX_HALF_SIZE && std::fabs(p.z - query.position.z) <= BOX_HALF_SIZE) {
+            results.push_back(slot);
+        }
+    }
+}
+
+// Slot of the first mob the ray enters, or NO_SLOT
+uint32_t scanRay(const EntityStorage& storage, const Query& query, float& bestDistance) {
+    glm::vec2 from(query.position.x, query.position.z);
+    glm::vec2 unit = glm::normalize(glm::vec2(query.direction.x, query.direction.z));
+    uint32_t bestSlot = SpatialHashGrid::NO_SLOT;
+    bestDistance = std::numeric_limits<float>::max();
+    for (uint32_t slot = 0; slot < storage.size(); ++slot) {
+        if (!accepts(storage, slot, query.kinds)) continue;
+        const glm::vec3& center = storage.positions[slot];
+        glm::vec2 offset = from - glm::vec2(center.x, center.z);
+        float c = glm::dot(offset, offset) - storage.radii[slot] * storage.radii[slot];
+        float distance = 0.0f;
+        if (c > 0.0f) {
+            float b = glm::dot(offset, unit);
+            float discriminant = b * b - c;
+            if (b >= 0.0f || discriminant < 0.0f) continue;
+            distance = -b - std::sqrt(discriminant);
+        }
+        if (distance <= RAY_LENGTH && distance < bestDistance) {
+            bestDistance = distance;
+            bestSlot = slot;
+        }
+    }
+    return bestSlot;
+}
+
+bool sameSlots(std::vector<uint32_t> a, std::vector<uint32_t> b) {
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+double microsecondsPerQuery(Clock::time_point start, size_t queryCount) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / queryCount;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int mobCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int queryCount = argc > 2 ? std::atoi(argv[2]) : 20000;
+
+    EntityManager manager;
+    manager.reserve(mobCount);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> positionDis(-ARENA_HALF_SIZE, ARENA_HALF_SIZE);
+    for (int i = 0; i < mobCount; ++i) {
+        std::shared_ptr<MobEntity> mob;
+        if (i % 50 == 0) {
+            mob = manager.spawn<PlayerEntity>();
+        } else {
+            mob = manager.spawn<EnemyEntity>();
+        }
+        mob->setPosition(glm::vec3(positionDis(gen), 0.0f, positionDis(gen)));
+    }
+    const EntityStorage& storage = manager.getStorage();
+
+    // Half the queries look for PCs only, the rest for any mob
+    std::vector<Query> queries(queryCount);
+    std::uniform_real_distribution<float> angleDis(0.0f, 6.2831853f);
+    for (int i = 0; i < queryCount; ++i) {
+        float angle = angleDis(gen);
+        queries[i].position = glm::vec3(positionDis(gen), 0.0f, positionDis(gen));
+        queries[i].direction = glm::vec3(std::cos(angle), 0.0f, std::sin(angle));
+        queries[i].kinds = i % 2 ? ANY_MOB_KIND : kindMask(EntityKind::Player);
+    }
+
+    std::vector<uint32_t> results;
+    std::vector<uint32_t> expected;
+    std::vector<std::pair<float, uint32_t>> scratch;
+    results.reserve(mobCount);
+    expected.reserve(mobCount);
+    scratch.reserve(mobCount);
+    uint64_t found = 0;
+    int mismatches = 0;
+    auto report = [&](const char* name, double gridUs, double scanUs) {
+        std::cout << "  " << name << std::setw(10) << gridUs << " us" << std::setw(12) << scanUs << " us"
+                  << std::setw(10) << (scanUs / gridUs) << "x" << std::setw(10)
+                  << (static_cast<double>(found) / queryCount) << std::endl;
+        found = 0;
+    };
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Spatial queries: " << mobCount << " mobs, " << queryCount << " queries per kind" << std::endl;
+    std::cout << "  query         grid        linear scan   speedup   results" << std::endl;
+
+    manager.queryRadius(queries[0].position, QUERY_RADIUS, results); // Builds the grid
+
+    // Radius
+    auto start = Clock::now();
+    for (const Query& query : queries) {
+        manager.queryRadius(query.position, QUERY_RADIUS, query.kinds, results);
+        found += results.size();
+    }
+    double gridUs = microsecondsPerQuery(start, queryCount);
+    start = Clock::now();
+    for (const Query& query : queries) {
+        scanRadius(storage, query, expected);
+    }
+    double scanUs = microsecondsPerQuery(start, queryCount);
+    for (const Query& query : queries) {
+        manager.queryRadius(query.position, QUERY_RADIUS, query.kinds, results);
+        scanRadius(storage, query, expected);
+        if (!sameSlots(results, expected)) mismatches++;
+    }
+    report("radius  ", gridUs, scanUs);
+
+    // K nearest, unbounded distance
+    const float unbounded = std::numeric_limits<float>::max();
+    start = Clock::now();
+    for (const Query& query : queries) {
+        manager.queryKNearest(query.position, NEAREST_COUNT, unbounded, query.kinds, results);
+        found += results.size();
+    }
+    gridUs = microsecondsPerQuery(start, queryCount);
+    start = Clock::now();
+    for (const Query& query : queries) {
+        scanKNearest(storage, query, scratch, expected);
+    }
+    scanUs = microsecondsPerQuery(start, queryCount);
+    for (const Query& query : queries) {
+        manager.queryKNearest(query.position, NEAREST_COUNT, unbounded, query.kinds, results);
+        scanKNearest(storage, query, scratch, expected);
+        if (results != expected) mismatches++;
+    }
+    report("k-near  ", gridUs, scanUs);
+
+    // Box
+    const glm::vec3 halfBox(BOX_HALF_SIZE, 0.0f, BOX_HALF_SIZE);
+    start = Clock::now();
+    for (const Query& query : queries) {
+        manager.queryAABB(query.position - halfBox, query.position + halfBox, query.kinds, results);
+        found += results.size();
+    }
+    gridUs = microsecondsPerQuery(start, queryCount);
+    start = Clock::now();
+    for (const Query& query : queries) {
+        scanAABB(storage, query, expected);
+    }
+    scanUs = microsecondsPerQuery(start, queryCount);
+    for (const Query& query : queries) {
+        manager.queryAABB(query.position - halfBox, query.position + halfBox, query.kinds, results);
+        scanAABB(storage, query, expected);
+        if (!sameSlots(results, expected)) mismatches++;
+    }
+    report("box     ", gridUs, scanUs);
+
+    // Ray
+    SpatialHashGrid::RayHit hit;
+    float distance;
+    start = Clock::now();
+    for (const Query& query : queries) {
+        found += manager.raycast(query.position, query.direction, RAY_LENGTH, query.kinds, hit) ? 1 : 0;
+    }
+    gridUs = microsecondsPerQuery(start, queryCount);
+    start = Clock::now();
+    for (const Query& query : queries) {
+        scanRay(storage, query, distance);
+    }
+    scanUs = microsecondsPerQuery(start, queryCount);
+    for (const Query& query : queries) {
+        bool gridHit = manager.raycast(query.position, query.direction, RAY_LENGTH, query.kinds, hit);
+        uint32_t slot = scanRay(storage, query, distance);
+        if (gridHit != (slot != SpatialHashGrid::NO_SLOT) || (gridHit && hit.slot != slot)) mismatches++;
+    }
+    report("ray     ", gridUs, scanUs);
+
+    if (mismatches > 0) {
+        std::cout << "MISMATCH: " << mismatches << " grid queries disagree with the linear scan" << std::endl;
+        return 1;
+    }
+    return 0;
+}
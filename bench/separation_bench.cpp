@@ -0,0 +1,121 @@
+// Separation kernel benchmark and cross-check.
+//
+// Runs every separation kernel the CPU supports over the same random
+// neighbor batches, reports ns per neighbor, and verifies that each SIMD
+// kernel matches the scalar one (same neighbor count, force within
+// tolerance). Exits non-zero on a mismatch.
+//
+// Usage: separation_bench [batchCount] [repetitions]
+
+#include "separation_kernel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct NeighborBatch {
+    glm::vec3 position;
+    float radius;
+    std::vector<float> xs, ys, zs, radii;
+};
+
+struct NamedKernel {
+    const char* name;
+    SeparationKernel kernel;
+};
+
+constexpr float FORCE_TOLERANCE = 1e-4f;
+
+std::vector<NeighborBatch> makeBatches(int batchCount) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> sizeDis(0, 67); // Odd sizes exercise the SIMD tails
+    std::uniform_real_distribution<float> offsetDis(-1.5f, 1.5f);
+    std::uniform_real_distribution<float> radiusDis(0.3f, 0.7f);
+
+    std::vector<NeighborBatch> batches(batchCount);
+    for (auto& batch : batches) {
+        batch.position = glm::vec3(offsetDis(gen) * 10.0f, 0.0f, offsetDis(gen) * 10.0f);
+        batch.radius = radiusDis(gen);
+
+        int size = sizeDis(gen);
+        for (int i = 0; i < size; ++i) {
+            // A few exact duplicates hit the coincident-position guard
+            bool coincident = (i % 17) == 16;
+            batch.xs.push_back(batch.position.x + (coincident ? 0.0f : offsetDis(gen)));
+            batch.ys.push_back(0.0f);
+            batch.zs.push_back(batch.position.z + (coincident ? 0.0f : offsetDis(gen)));
+            batch.radii.push_back(radiusDis(gen));
+        }
+    }
+    return batches;
+}
+
+SeparationResult run(SeparationKernel kernel, const NeighborBatch& batch) {
+    return kernel(batch.position, batch.radius, batch.xs.data(), batch.ys.data(), batch.zs.data(),
+                  batch.radii.data(), batch.xs.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int batchCount = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::vector<NamedKernel> kernels = {{"scalar", separationKernelScalar}};
+#if defined(ACTIONRPG_HAS_X86_KERNELS)
+    if (cpuSupportsSSE2()) kernels.push_back({"sse2", separationKernelSSE});
+    if (cpuSupportsAVX2()) kernels.push_back({"avx2", separationKernelAVX2});
+#endif
+
+    std::vector<NeighborBatch> batches = makeBatches(batchCount);
+    size_t neighborCount = 0;
+    for (const auto& batch : batches) {
+        neighborCount += batch.xs.size();
+    }
+
+    std::cout << "Batches: " << batchCount << ", neighbors: " << neighborCount
+              << ", selected kernel: " << getSeparationKernelName() << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    bool allMatch = true;
+    for (const auto& named : kernels) {
+        // Correctness against the scalar reference
+        float maxError = 0.0f;
+        bool countsMatch = true;
+        for (const auto& batch : batches) {
+            SeparationResult expected = run(separationKernelScalar, batch);
+            SeparationResult actual = run(named.kernel, batch);
+
+            countsMatch = countsMatch && expected.count == actual.count;
+            glm::vec3 error = glm::abs(expected.force - actual.force);
+            maxError = std::max(maxError, std::max(error.x, std::max(error.y, error.z)));
+        }
+        bool matches = countsMatch && maxError <= FORCE_TOLERANCE;
+        allMatch = allMatch && matches;
+
+        // Throughput
+        float sink = 0.0f;
+        auto start = Clock::now();
+        for (int r = 0; r < repetitions; ++r) {
+            for (const auto& batch : batches) {
+                sink += run(named.kernel, batch).force.x;
+            }
+        }
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        double nsPerNeighbor = elapsed.count() / (static_cast<double>(neighborCount) * repetitions);
+
+        std::cout << "  " << std::setw(6) << named.name << ": " << nsPerNeighbor << " ns/neighbor, max error "
+                  << std::scientific << maxError << std::fixed
+                  << (matches ? "  OK" : "  MISMATCH") << (sink == 12345.0f ? " " : "") << std::endl;
+    }
+
+    return allMatch ? 0 : 1;
+}
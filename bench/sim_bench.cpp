@@ -0,0 +1,145 @@
+// Headless simulation throughput benchmark.
+//
+// Spawns enemyCount BasicShooterEnemy around the default party, runs
+// tickCount fixed-step ticks with no window or GL, and reports ticks/sec,
+// p50/p99 tick time and time per entity.
+//
+// Usage: sim_bench [enemyCount] [tickCount] [workerThreads] [--sequential] [--no-flowfield]
+//                  [--ai-budget=MICROSECONDS] [--no-sleep] [--no-party]
+//   workerThreads defaults to 0 (one per hardware thread)
+//   --no-flowfield makes every enemy search for the closest PC itself
+//   --ai-budget caps the time spent on time-sliced enemy decisions per tick
+//   --no-sleep keeps every mob awake
+//   --no-party leaves the enemies without a target, as an idle crowd in a cleared area
+
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double percentile(std::vector<double> sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(std::ceil(fraction * sorted.size())) - 1;
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<const char*> positional;
+    bool sequential = false;
+    bool flowField = true;
+    double aiBudget = 0.0;
+    bool sleep = true;
+    bool party = true;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--sequential") == 0) {
+            sequential = true;
+        } else if (std::strcmp(argv[i], "--no-flowfield") == 0) {
+            flowField = false;
+        } else if (std::strncmp(argv[i], "--ai-budget=", 12) == 0) {
+            aiBudget = std::atof(argv[i] + 12);
+        } else if (std::strcmp(argv[i], "--no-sleep") == 0) {
+            sleep = false;
+        } else if (std::strcmp(argv[i], "--no-party") == 0) {
+            party = false;
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+
+    int enemyCount = positional.size() > 0 ? std::atoi(positional[0]) : 1000;
+    int tickCount = positional.size() > 1 ? std::atoi(positional[1]) : 600;
+    size_t workerThreads = positional.size() > 2 ? static_cast<size_t>(std::atoi(positional[2])) : 0;
+    if (enemyCount <= 0 || tickCount <= 0) {
+        std::cerr << "enemyCount and tickCount must be positive" << std::endl;
+        return 1;
+    }
+
+    Simulation simulation(sequential ? UpdateMode::Sequential : UpdateMode::Parallel, workerThreads);
+    simulation.getEntityManager().reserve(enemyCount + 3);
+    simulation.getEntityManager().setFlowFieldEnabled(flowField);
+    simulation.getEntityManager().getAIScheduler().setBudget(aiBudget);
+    simulation.getEntityManager().setSleepEnabled(sleep);
+    if (party) {
+        simulation.createParty();
+    }
+
+    // Ring of enemies around the party, as a wave would arrive
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<float> angleDis(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> distanceDis(10.0f, 10.0f + std::sqrt(static_cast<float>(enemyCount)));
+    for (int i = 0; i < enemyCount; ++i) {
+        float angle = angleDis(gen);
+        float distance = distanceDis(gen);
+        simulation.spawnEnemy(glm::vec3(std::cos(angle) * distance, 0.0f, std::sin(angle) * distance));
+    }
+
+    const float deltaTime = static_cast<float>(Simulation::TIMESTEP);
+    std::vector<double> tickMs;
+    tickMs.reserve(tickCount);
+
+    // Per-tier agent and decision-update totals over the run
+    uint64_t tierAgents[AIScheduler::TIER_COUNT] = {};
+    uint64_t tierUpdated[AIScheduler::TIER_COUNT] = {};
+    uint64_t deferred = 0;
+    uint64_t sleeping = 0;
+
+    auto runStart = Clock::now();
+    for (int tick = 0; tick < tickCount; ++tick) {
+        auto tickStart = Clock::now();
+        simulation.step(deltaTime);
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - tickStart;
+        tickMs.push_back(elapsed.count());
+
+        const AIScheduler::Stats& stats = simulation.getEntityManager().getAIScheduler().getStats();
+        for (size_t tier = 0; tier < AIScheduler::TIER_COUNT; ++tier) {
+            tierAgents[tier] += stats.agents[tier];
+            tierUpdated[tier] += stats.updated[tier];
+        }
+        deferred += stats.deferred;
+        sleeping += simulation.getEntityManager().getSleepingCount();
+    }
+    std::chrono::duration<double> total = Clock::now() - runStart;
+
+    size_t entityCount = simulation.getEntityManager().getEntities().size();
+    double meanMs = total.count() * 1000.0 / tickCount;
+    std::sort(tickMs.begin(), tickMs.end());
+
+    std::cout << "Entities: " << entityCount << " (" << enemyCount << " enemies), ticks: " << tickCount
+              << ", mode: " << (sequential ? "sequential" : "parallel")
+              << (flowField ? "" : ", no flow field") << (sleep ? "" : ", no sleep") << (party ? "" : ", no party");
+    if (aiBudget > 0.0) {
+        std::cout << ", AI budget " << aiBudget << " us";
+    }
+    std::cout << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  ticks/sec:       " << (tickCount / total.count()) << std::endl;
+    std::cout << "  tick p50:        " << percentile(tickMs, 0.50) << " ms" << std::endl;
+    std::cout << "  tick p99:        " << percentile(tickMs, 0.99) << " ms" << std::endl;
+    std::cout << "  tick mean:       " << meanMs << " ms" << std::endl;
+    std::cout << "  per entity:      " << (meanMs * 1000.0 / entityCount) << " us/tick" << std::endl;
+
+    const char* tierNames[AIScheduler::TIER_COUNT] = {"near", "mid", "far"};
+    std::cout << std::setprecision(1);
+    for (size_t tier = 0; tier < AIScheduler::TIER_COUNT; ++tier) {
+        std::cout << "  AI " << std::left << std::setw(5) << tierNames[tier] << std::right
+                  << "       " << (static_cast<double>(tierAgents[tier]) / tickCount) << " agents, "
+                  << (static_cast<double>(tierUpdated[tier]) / tickCount) << " decisions/tick" << std::endl;
+    }
+    std::cout << "  AI deferred:     " << (static_cast<double>(deferred) / tickCount) << " /tick" << std::endl;
+    std::cout << "  sleeping mobs:   " << (static_cast<double>(sleeping) / tickCount) << " avg, "
+              << simulation.getEntityManager().getSleepingCount() << " at end" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Headless replay of a recorded session (see Game --record).
+//
+// Rebuilds the simulation from the recording's seed and update mode, feeds
+// the recorded inputs back tick by tick with no window or frame pacing, and
+// reports tick timings, the slowest ticks and a hash of the final entity
+// positions. The same recording on the same build gives the same hash, so a
+// frame-time spike can be bisected across commits.
+//
+// Usage: sim_replay <recording> [workerThreads] [--verify] [--slowest=N]
+//   workerThreads defaults to 0 (one per hardware thread); results do not depend on it
+//   --verify replays a second time and fails if the final state differs
+
+#include "input_record.h"
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct ReplayResult {
+    std::vector<double> tickMs;
+    size_t entityCount;
+    uint64_t stateHash;
+};
+
+// FNV-1a over the raw bits of every entity position
+uint64_t hashPositions(const EntityStorage& storage) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const glm::vec3& position : storage.positions) {
+        const float components[3] = {position.x, position.y, position.z};
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(components);
+        for (size_t i = 0; i < sizeof(components); ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+ReplayResult replay(const InputReplay& recording, size_t workerThreads) {
+    Simulation simulation(recording.getUpdateMode(), workerThreads, recording.getSeed());
+    simulation.createParty();
+
+    const float deltaTime = static_cast<float>(Simulation::TIMESTEP);
+    ReplayResult result;
+    result.tickMs.reserve(recording.getTickCount());
+
+    std::vector<SimCommand> commands;
+    for (uint64_t tick = 0; tick < recording.getTickCount(); ++tick) {
+        commands.clear();
+        recording.commandsForTick(tick, commands);
+        for (const SimCommand& command : commands) {
+            simulation.queueCommand(command);
+        }
+
+        auto tickStart = Clock::now();
+        simulation.step(deltaTime);
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - tickStart;
+        result.tickMs.push_back(elapsed.count());
+    }
+
+    result.entityCount = simulation.getEntityManager().getEntities().size();
+    result.stateHash = hashPositions(simulation.getEntityManager().getStorage());
+    return result;
+}
+
+double percentile(std::vector<double> sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(std::ceil(fraction * sorted.size())) - 1;
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<const char*> positional;
+    bool verify = false;
+    size_t slowestCount = 5;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+        } else if (std::strncmp(argv[i], "--slowest=", 10) == 0) {
+            slowestCount = static_cast<size_t>(std::atoi(argv[i] + 10));
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+
+    if (positional.empty()) {
+        std::cerr << "Usage: sim_replay <recording> [workerThreads] [--verify] [--slowest=N]" << std::endl;
+        return 1;
+    }
+    size_t workerThreads = positional.size() > 1 ? static_cast<size_t>(std::atoi(positional[1])) : 0;
+
+    InputReplay recording;
+    if (!recording.load(positional[0])) {
+        return 1;
+    }
+
+    std::cout << "Recording: " << recording.getTickCount() << " ticks, " << recording.getCommandCount()
+              << " inputs, seed " << recording.getSeed() << ", mode "
+              << (recording.getUpdateMode() == UpdateMode::Sequential ? "sequential" : "parallel") << std::endl;
+
+    auto runStart = Clock::now();
+    ReplayResult result = replay(recording, workerThreads);
+    std::chrono::duration<double> total = Clock::now() - runStart;
+
+    std::vector<double> sorted = result.tickMs;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  replayed in:     " << total.count() << " s (" << (result.tickMs.size() / total.count())
+              << " ticks/sec)" << std::endl;
+    std::cout << "  tick p50:        " << percentile(sorted, 0.50) << " ms" << std::endl;
+    std::cout << "  tick p99:        " << percentile(sorted, 0.99) << " ms" << std::endl;
+    std::cout << "  tick max:        " << percentile(sorted, 1.0) << " ms" << std::endl;
+    std::cout << "  final entities:  " << result.entityCount << std::endl;
+    std::cout << "  state hash:      " << std::hex << result.stateHash << std::dec << std::endl;
+
+    // Tick numbers of the worst spikes, to replay or profile in isolation
+    std::vector<std::pair<double, uint64_t>> slowest;
+    for (uint64_t tick = 0; tick < result.tickMs.size(); ++tick) {
+        slowest.push_back({result.tickMs[tick], tick});
+    }
+    slowestCount = std::min(slowestCount, slowest.size());
+    std::partial_sort(slowest.begin(), slowest.begin() + slowestCount, slowest.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (size_t i = 0; i < slowestCount; ++i) {
+        std::cout << "  slow tick " << slowest[i].second << ": " << slowest[i].first << " ms" << std::endl;
+    }
+
+    if (verify) {
+        ReplayResult second = replay(recording, workerThreads);
+        if (second.stateHash != result.stateHash) {
+            std::cerr << "Replay is not deterministic: state hash " << std::hex << second.stateHash
+                      << " on the second run" << std::dec << std::endl;
+            return 1;
+        }
+        std::cout << "  verified:        second replay matches" << std::endl;
+    }
+
+    return 0;
+}
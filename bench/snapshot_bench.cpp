@@ -0,0 +1,164 @@
+// World snapshot save/load benchmark.
+//
+// Builds an arena of enemyCount BasicShooterEnemy around the default party,
+// runs a few ticks so the hot state is non-trivial, then saves and reloads it
+// repeatCount times. Reports file size and save/load times, and checks that
+// the loaded world matches: same positions, every saved handle resolves to
+// the same slot and every enemy target still resolves to a PC.
+//
+// Usage: snapshot_bench [enemyCount] [repeatCount] [path]
+//   path defaults to snapshot_bench.arps in the working directory
+
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// FNV-1a over the raw bits of every entity position
+uint64_t hashPositions(const EntityStorage& storage) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const glm::vec3& position : storage.positions) {
+        const float components[3] = {position.x, position.y, position.z};
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(components);
+        for (size_t i = 0; i < sizeof(components); ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+// Every handle of the original world resolves to the same slot in the loaded one
+bool handlesMatch(const EntityManager& original, const EntityManager& loaded) {
+    for (const auto& entity : original.getEntities()) {
+        uint32_t slot;
+        if (!loaded.tryGetSlot(entity->getHandle(), slot) || slot != entity->getSlot()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Count enemies whose target no longer resolves to a PC
+size_t countLostTargets(const EntityManager& manager) {
+    size_t lost = 0;
+    for (const auto& entity : manager.getEntities()) {
+        auto shooter = dynamic_cast<const BasicShooterEnemy*>(entity.get());
+        if (!shooter || !shooter->target.isValid()) continue;
+        Entity* target = manager.resolve(shooter->target);
+        if (!target || target->getKind() != EntityKind::Player) {
+            lost++;
+        }
+    }
+    return lost;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int enemyCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int repeatCount = argc > 2 ? std::atoi(argv[2]) : 5;
+    std::string path = argc > 3 ? argv[3] : "snapshot_bench.arps";
+
+    Simulation simulation(UpdateMode::Sequential, 1, 1);
+    simulation.createParty();
+
+    // Spread the enemies over an arena that grows with the count
+    std::mt19937 gen(42);
+    float halfExtent = std::max(15.0f, std::sqrt(static_cast<float>(enemyCount)) * 0.75f);
+    std::uniform_real_distribution<float> dis(-halfExtent, halfExtent);
+    simulation.getEntityManager().reserve(enemyCount + simulation.getParty().size());
+    for (int i = 0; i < enemyCount; ++i) {
+        float x = dis(gen);
+        float z = dis(gen);
+        simulation.spawnEnemy(glm::vec3(x, 0.0f, z));
+    }
+
+    const float deltaTime = static_cast<float>(Simulation::TIMESTEP);
+    for (int tick = 0; tick < 10; ++tick) {
+        simulation.step(deltaTime);
+    }
+
+    const EntityManager& original = simulation.getEntityManager();
+    uint64_t originalHash = hashPositions(original.getStorage());
+
+    std::vector<double> saveMs;
+    std::vector<double> loadMs;
+    Simulation loaded(UpdateMode::Sequential, 1, 1);
+    for (int i = 0; i < repeatCount; ++i) {
+        auto saveStart = Clock::now();
+        if (!simulation.saveSnapshot(path)) {
+            return 1;
+        }
+        std::chrono::duration<double, std::milli> saveElapsed = Clock::now() - saveStart;
+        saveMs.push_back(saveElapsed.count());
+
+        auto loadStart = Clock::now();
+        if (!loaded.loadSnapshot(path)) {
+            return 1;
+        }
+        std::chrono::duration<double, std::milli> loadElapsed = Clock::now() - loadStart;
+        loadMs.push_back(loadElapsed.count());
+    }
+
+    long fileBytes = 0;
+    if (FILE* file = fopen(path.c_str(), "rb")) {
+        fseek(file, 0, SEEK_END);
+        fileBytes = ftell(file);
+        fclose(file);
+    }
+
+    const EntityManager& restored = loaded.getEntityManager();
+    size_t entityCount = original.getEntities().size();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Snapshot of " << entityCount << " entities (" << repeatCount << " runs)" << std::endl;
+    std::cout << "  file size:       " << (fileBytes / 1024.0) << " KiB (" << (static_cast<double>(fileBytes) / entityCount)
+              << " bytes/entity)" << std::endl;
+    std::cout << "  save median:     " << median(saveMs) << " ms" << std::endl;
+    std::cout << "  load median:     " << median(loadMs) << " ms" << std::endl;
+
+    bool ok = true;
+    if (restored.getEntities().size() != entityCount || hashPositions(restored.getStorage()) != originalHash) {
+        std::cerr << "Loaded positions differ from the saved world" << std::endl;
+        ok = false;
+    }
+    if (!handlesMatch(original, restored)) {
+        std::cerr << "Saved handles do not resolve to the same slots after loading" << std::endl;
+        ok = false;
+    }
+    if (loaded.getParty().size() != simulation.getParty().size()) {
+        std::cerr << "Party not restored" << std::endl;
+        ok = false;
+    }
+    size_t lostTargets = countLostTargets(restored);
+    if (lostTargets > 0) {
+        std::cerr << lostTargets << " enemy targets no longer resolve after loading" << std::endl;
+        ok = false;
+    }
+
+    // The loaded world keeps running
+    for (int tick = 0; tick < 10; ++tick) {
+        loaded.step(deltaTime);
+    }
+
+    if (ok) {
+        std::cout << "  verified:        positions, handles, targets and party match" << std::endl;
+    }
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+// Derived stat reads: StatBlock's precomputed values vs. folding the
+// modifier stack on every read.
+//
+// Gives every mob a few gear modifiers, then each tick reads every mob's
+// movement and attack speed the way the update loop does, while a small
+// share of mobs gains or loses a buff. The same stacks are kept as plain
+// per-mob vectors that are folded on each read. Reports read time per mob
+// and modifier change cost, and exits non-zero if the two ever disagree.
+//
+// Usage: stat_bench [mobCount] [tickCount] [modifiersPerMob]
+
+#include "stat_block.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const uint32_t BUFF_SOURCE = 1000;
+const double CHURN_PER_TICK = 0.01; // Share of mobs whose buff toggles each tick
+
+// Same formula as StatBlock, evaluated from scratch
+float foldModifiers(const std::vector<StatModifier>& modifiers, Stat stat, float base) {
+    float flat = 0.0f;
+    float increased = 0.0f;
+    float more = 1.0f;
+    for (const StatModifier& modifier : modifiers) {
+        if (modifier.stat != stat) continue;
+        switch (modifier.kind) {
+            case ModifierKind::Flat:
+                flat += modifier.value;
+                break;
+            case ModifierKind::Increased:
+                increased += modifier.value;
+                break;
+            case ModifierKind::More:
+                more *= 1.0f + modifier.value;
+                break;
+        }
+    }
+    return std::max(0.0f, (base + flat) * (1.0f + increased) * more);
+}
+
+struct PlainStats {
+    float baseSpeed;
+    float baseAttackSpeed;
+    std::vector<StatModifier> modifiers;
+};
+
+double nanosecondsPer(double seconds, uint64_t count) {
+    return count ? seconds * 1e9 / static_cast<double>(count) : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int mobCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int tickCount = argc > 2 ? std::atoi(argv[2]) : 600;
+    int modifiersPerMob = argc > 3 ? std::atoi(argv[3]) : 8;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> speedDist(3.0f, 6.0f);
+    std::uniform_real_distribution<float> valueDist(0.0f, 0.3f);
+    std::uniform_int_distribution<int> statDist(0, static_cast<int>(STAT_COUNT) - 1);
+    std::uniform_int_distribution<int> kindDist(0, 2);
+
+    std::vector<StatBlock> blocks(mobCount);
+    std::vector<PlainStats> plain(mobCount);
+    for (int i = 0; i < mobCount; ++i) {
+        float speed = speedDist(rng);
+        blocks[i].setBase(Stat::MovementSpeed, speed);
+        plain[i].baseSpeed = speed;
+        plain[i].baseAttackSpeed = blocks[i].getBase(Stat::AttackSpeed);
+
+        for (int m = 0; m < modifiersPerMob; ++m) {
+            StatModifier modifier{static_cast<uint32_t>(m), valueDist(rng), static_cast<Stat>(statDist(rng)),
+                                  static_cast<ModifierKind>(kindDist(rng))};
+            blocks[i].addModifier(modifier);
+            plain[i].modifiers.push_back(modifier);
+        }
+    }
+
+    std::vector<uint8_t> buffed(mobCount, 0);
+    std::uniform_int_distribution<int> mobDist(0, mobCount - 1);
+    const int churnPerTick = std::max(1, static_cast<int>(mobCount * CHURN_PER_TICK));
+
+    double cachedRead = 0.0;
+    double foldedRead = 0.0;
+    double cachedChange = 0.0;
+    double foldedChange = 0.0;
+    uint64_t changes = 0;
+    bool mismatch = false;
+
+    for (int tick = 0; tick < tickCount; ++tick) {
+        // A few mobs gain or lose a haste buff
+        std::vector<int> churned;
+        for (int c = 0; c < churnPerTick; ++c) churned.push_back(mobDist(rng));
+        std::sort(churned.begin(), churned.end());
+        churned.erase(std::unique(churned.begin(), churned.end()), churned.end());
+        const float haste = valueDist(rng);
+
+        auto changeBlocks = [&]() {
+            auto start = Clock::now();
+            for (int i : churned) {
+                if (buffed[i]) {
+                    blocks[i].removeModifiers(BUFF_SOURCE);
+                } else {
+                    blocks[i].addModifier({BUFF_SOURCE, haste, Stat::MovementSpeed, ModifierKind::More});
+                    blocks[i].addModifier({BUFF_SOURCE, haste, Stat::AttackSpeed, ModifierKind::Increased});
+                }
+            }
+            cachedChange += std::chrono::duration<double>(Clock::now() - start).count();
+        };
+        auto changePlain = [&]() {
+            auto start = Clock::now();
+            for (int i : churned) {
+                std::vector<StatModifier>& modifiers = plain[i].modifiers;
+                if (buffed[i]) {
+                    modifiers.erase(std::remove_if(modifiers.begin(), modifiers.end(),
+                                                   [](const StatModifier& m) { return m.source == BUFF_SOURCE; }),
+                                    modifiers.end());
+                } else {
+                    modifiers.push_back({BUFF_SOURCE, haste, Stat::MovementSpeed, ModifierKind::More});
+                    modifiers.push_back({BUFF_SOURCE, haste, Stat::AttackSpeed, ModifierKind::Increased});
+                }
+            }
+            foldedChange += std::chrono::duration<double>(Clock::now() - start).count();
+        };
+
+        // Whichever goes first pays for pulling the mobs into cache, so take turns
+        if (tick % 2 == 0) {
+            changeBlocks();
+            changePlain();
+        } else {
+            changePlain();
+            changeBlocks();
+        }
+        for (int i : churned) buffed[i] ^= 1;
+        changes += churned.size();
+
+        // Every mob reads its speeds once per tick
+        double cachedSum = 0.0;
+        auto start = Clock::now();
+        for (int i = 0; i < mobCount; ++i) {
+            cachedSum += blocks[i].get(Stat::MovementSpeed) + blocks[i].get(Stat::AttackSpeed);
+        }
+        auto read = Clock::now();
+        double foldedSum = 0.0;
+        for (int i = 0; i < mobCount; ++i) {
+            foldedSum += foldModifiers(plain[i].modifiers, Stat::MovementSpeed, plain[i].baseSpeed) +
+                         foldModifiers(plain[i].modifiers, Stat::AttackSpeed, plain[i].baseAttackSpeed);
+        }
+        cachedRead += std::chrono::duration<double>(read - start).count();
+        foldedRead += std::chrono::duration<double>(Clock::now() - read).count();
+
+        if (cachedSum != foldedSum) mismatch = true;
+    }
+
+    const uint64_t reads = static_cast<uint64_t>(mobCount) * tickCount;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Stats: " << mobCount << " mobs x " << modifiersPerMob << " modifiers, " << tickCount << " ticks, "
+              << churnPerTick << " buff changes per tick" << std::endl;
+    std::cout << "                 read ns/mob  change ns/buff" << std::endl;
+    std::cout << "  StatBlock      " << std::setw(11) << nanosecondsPer(cachedRead, reads) << std::setw(16)
+              << nanosecondsPer(cachedChange, changes) << std::endl;
+    std::cout << "  fold on read   " << std::setw(11) << nanosecondsPer(foldedRead, reads) << std::setw(16)
+              << nanosecondsPer(foldedChange, changes) << std::endl;
+
+    if (mismatch) {
+        std::cout << "MISMATCH: precomputed stats differ from folding the modifier stacks" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+// Gameplay timers: TimerWheel vs. every timer counting itself down each tick.
+//
+// Keeps timerCount cooldown/buff style timers live (random durations of a
+// fraction of a second to several seconds at 60 Hz). Whenever one fires it is
+// rescheduled with a new duration, and a few timers are cancelled and
+// restarted every tick, as when a buff is refreshed. The same workload runs
+// as a flat array of remaining ticks decremented every tick. Reports time per
+// tick for both and exits non-zero if they ever fire different timers.
+//
+// Usage: timer_bench [timerCount] [tickCount]
+
+#include "timer_wheel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const uint32_t MIN_DURATION = 20;   // ticks
+const uint32_t MAX_DURATION = 1200; // ticks
+const double RESTARTS_PER_TICK = 0.002; // Share of timers cancelled and restarted each tick
+
+// Order-independent digest of which timers fired on which tick
+uint64_t mixFired(uint64_t hash, uint32_t id, uint64_t tick) {
+    uint64_t x = (static_cast<uint64_t>(id) << 32) ^ tick;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    return hash + x;
+}
+
+// Duration of a timer's nth start; the same whichever order timers restart in
+uint32_t durationFor(uint32_t id, uint32_t start) {
+    uint64_t x = (static_cast<uint64_t>(id) << 32 | start) * 0x9e3779b97f4a7c15ull;
+    x ^= x >> 29;
+    return MIN_DURATION + static_cast<uint32_t>(x % (MAX_DURATION - MIN_DURATION + 1));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int timerCount = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int tickCount = argc > 2 ? std::atoi(argv[2]) : 3600;
+
+    const int restartsPerTick = std::max(1, static_cast<int>(timerCount * RESTARTS_PER_TICK));
+
+    // Which timers get restarted on each tick, shared by both runs
+    std::mt19937 pickRng(11);
+    std::uniform_int_distribution<int> pickDist(0, timerCount - 1);
+    std::vector<uint32_t> restarts(static_cast<size_t>(restartsPerTick) * tickCount);
+    for (uint32_t& id : restarts) id = static_cast<uint32_t>(pickDist(pickRng));
+
+    // Timer wheel: ids ride along in the data field
+    TimerWheel wheel;
+    wheel.reserve(timerCount);
+    std::vector<TimerHandle> handles(timerCount);
+    std::vector<uint32_t> starts(timerCount, 0);
+    std::vector<TimerWheel::Expiry> expired;
+    for (int id = 0; id < timerCount; ++id) {
+        handles[id] = wheel.schedule(durationFor(id, 0), EntityHandle(), 0, static_cast<uint32_t>(id));
+    }
+
+    uint64_t wheelHash = 0;
+    uint64_t wheelFired = 0;
+    auto start = Clock::now();
+    for (int tick = 0; tick < tickCount; ++tick) {
+        for (int r = 0; r < restartsPerTick; ++r) {
+            uint32_t id = restarts[static_cast<size_t>(tick) * restartsPerTick + r];
+            wheel.cancel(handles[id]);
+            handles[id] = wheel.schedule(durationFor(id, ++starts[id]), EntityHandle(), 0, id);
+        }
+
+        expired.clear();
+        wheel.advance(1, expired);
+        for (const TimerWheel::Expiry& expiry : expired) {
+            wheelHash = mixFired(wheelHash, expiry.data, expiry.tick);
+            uint32_t id = expiry.data;
+            handles[id] = wheel.schedule(durationFor(id, ++starts[id]), EntityHandle(), 0, id);
+        }
+        wheelFired += expired.size();
+    }
+    double wheelSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Countdown: every timer is decremented every tick
+    std::vector<uint32_t> remaining(timerCount);
+    std::fill(starts.begin(), starts.end(), 0);
+    for (int id = 0; id < timerCount; ++id) {
+        remaining[id] = durationFor(id, 0);
+    }
+
+    uint64_t countdownHash = 0;
+    uint64_t countdownFired = 0;
+    start = Clock::now();
+    for (int tick = 0; tick < tickCount; ++tick) {
+        for (int r = 0; r < restartsPerTick; ++r) {
+            uint32_t id = restarts[static_cast<size_t>(tick) * restartsPerTick + r];
+            remaining[id] = durationFor(id, ++starts[id]);
+        }
+
+        for (uint32_t id = 0; id < static_cast<uint32_t>(timerCount); ++id) {
+            if (--remaining[id] == 0) {
+                countdownHash = mixFired(countdownHash, id, static_cast<uint64_t>(tick) + 1);
+                countdownFired++;
+                remaining[id] = durationFor(id, ++starts[id]);
+            }
+        }
+    }
+    double countdownSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Timers: " << timerCount << " live, " << tickCount << " ticks, " << restartsPerTick
+              << " restarts per tick" << std::endl;
+    std::cout << "  TimerWheel  " << std::setw(8) << wheelSeconds * 1000.0 / tickCount << " ms/tick  ("
+              << wheelFired << " fired)" << std::endl;
+    std::cout << "  countdown   " << std::setw(8) << countdownSeconds * 1000.0 / tickCount << " ms/tick  ("
+              << countdownFired << " fired)" << std::endl;
+
+    if (wheelFired != countdownFired || wheelHash != countdownHash) {
+        std::cout << "MISMATCH: the wheel and the countdown fired different timers" << std::endl;
+        return 1;
+    }
+    return 0;
+}
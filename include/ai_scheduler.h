@@ -0,0 +1,114 @@
+#pragma once
+
+#include "entity_storage.h"
+#include "flow_field.h"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct Entity;
+
+// Update-rate tier of an AI agent, by distance to the nearest PC
+enum class AITier : uint8_t {
+    Near, // Thinks every tick
+    Mid,  // Thinks every MID_INTERVAL ticks
+    Far   // Thinks every FAR_INTERVAL ticks
+};
+
+/**
+ * AIScheduler - Decides which enemies run their decision logic each tick
+ *
+ * Features:
+ * - Distance LOD: near enemies think every tick, mid and far ones every few
+ *   ticks, with their turns staggered so the work is spread across ticks
+ * - Idle enemies (moved less than IDLE_STEP last tick) drop one tier
+ * - Optional per-tick time budget for the sliced tiers; agents pushed past
+ *   it keep their place and go first on the next tick
+ * - Per-tier counters of agents and decision updates for the last tick
+ *
+ * Only decisions are sliced: every enemy still moves each tick along the
+ * last direction it chose. Agents are tracked by handle index, so the
+ * schedule survives slot swaps.
+ *
+ * With no budget set the schedule depends only on positions and tick count,
+ * so parallel updates stay deterministic. A budget makes it depend on
+ * measured timings.
+ */
+class AIScheduler {
+public:
+    static constexpr size_t TIER_COUNT = 3;
+    static constexpr uint32_t MID_INTERVAL = 4;
+    static constexpr uint32_t FAR_INTERVAL = 12;
+
+    // Movement per tick below which an agent counts as idle
+    static constexpr float IDLE_STEP = 0.001f;
+
+    // Agents always allowed through the budget each tick, so far ones cannot starve
+    static constexpr uint32_t MIN_SLICED_THINKS = 8;
+
+    struct Stats {
+        uint32_t agents[TIER_COUNT];  // Agents in each tier
+        uint32_t updated[TIER_COUNT]; // Decision updates run in each tier
+        uint32_t deferred;            // Due agents pushed to a later tick by the budget
+        double thinkMicroseconds;     // Measured decision time (only with a budget)
+    };
+
+    AIScheduler();
+
+    // Distances (to the nearest PC) below which an agent counts as near / mid
+    void setTierDistances(float nearDistance, float midDistance);
+
+    // Microseconds of decision updates allowed per tick for the sliced tiers; 0 = unlimited
+    void setBudget(double microseconds) { budgetMicroseconds = microseconds; }
+    double getBudget() const { return budgetMicroseconds; }
+
+    // Pick this tick's thinkers among the active enemies. party holds the active PC positions.
+    // Must run before the storage captures this tick's previous positions.
+    void plan(const std::vector<std::shared_ptr<Entity>>& entities, const EntityStorage& storage,
+              const FlowField& flowField, const std::vector<FlowField::Goal>& party);
+
+    bool shouldThink(uint32_t slot) const { return slot >= thinkFlags.size() || thinkFlags[slot] != 0; }
+
+    // Decision updates report their duration while a budget is set (thread-safe)
+    bool isTiming() const { return budgetMicroseconds > 0.0; }
+    void recordThinkTime(uint64_t nanoseconds) { thinkNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed); }
+
+    const Stats& getStats() const { return stats; }
+
+    // Forget all agents and restart the tick count (budget and distances are kept)
+    void reset();
+
+private:
+    struct AgentState {
+        uint32_t generation; // Handle generation the entry belongs to
+        uint64_t lastThinkTick;
+    };
+
+    struct Candidate {
+        uint32_t slot;
+        uint32_t handleIndex;
+        uint64_t overdue; // Ticks past the agent's interval
+        AITier tier;
+    };
+
+    float nearDistanceSq;
+    float midDistanceSq;
+    double budgetMicroseconds;
+
+    uint64_t tick;
+    std::vector<AgentState> agents; // Indexed by handle index
+    std::vector<uint8_t> thinkFlags; // Indexed by slot, for the current tick
+    std::vector<Candidate> candidates;
+
+    // Think time of the previous tick and a running per-think average
+    std::atomic<uint64_t> thinkNanoseconds;
+    uint32_t lastThinkCount;
+    double averageThinkNanoseconds;
+
+    Stats stats;
+
+    AITier classify(const glm::vec3& position, bool idle, const FlowField& flowField,
+                    const std::vector<FlowField::Goal>& party) const;
+};
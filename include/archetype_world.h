@@ -0,0 +1,307 @@
+#pragma once
+
+#include "entity_handle.h"
+#include "thread_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// One bit per registered component type
+using ComponentMask = uint64_t;
+
+/**
+ * ArchetypeWorld - Archetype-based entity-component store
+ *
+ * Features:
+ * - Entities with the same set of component types share an archetype, which
+ *   keeps them in fixed-size chunks of CHUNK_BYTES. A chunk holds one packed
+ *   array per component (plus the entities' handles), so a system that reads
+ *   two components streams exactly two arrays.
+ * - Queries name the component types they need and visit only the chunks of
+ *   archetypes that have all of them, in a stable order; parallelForEachChunk
+ *   hands whole chunks to a ThreadPool
+ * - Entities are referred to by generational EntityHandles from the world's
+ *   own handle table; destroying one swaps the archetype's last entity into
+ *   its row, so every chunk but an archetype's last is full
+ * - Adding or removing a component moves the entity into the archetype for
+ *   its new component set
+ *
+ * Components must be trivially copyable (rows are moved with memcpy), no
+ * more than MAX_COMPONENT_TYPES types may be used, every entity's row must
+ * fit in one chunk and at most EntityHandle::INDEX_MASK + 1 entities may be
+ * alive at once; breaking any of these limits aborts. Nothing may create or
+ * destroy entities, or add or remove components, while a query is running.
+ */
+class ArchetypeWorld {
+public:
+    static constexpr size_t CHUNK_BYTES = 16 * 1024;
+    static constexpr size_t MAX_COMPONENT_TYPES = 64;
+
+    // Process-wide id of component type T, assigned on first use
+    template <typename T>
+    static uint32_t componentId();
+
+    ArchetypeWorld() = default;
+    ~ArchetypeWorld() = default;
+
+    ArchetypeWorld(const ArchetypeWorld&) = delete;
+    ArchetypeWorld& operator=(const ArchetypeWorld&) = delete;
+
+    // New entity with exactly these components (each type at most once)
+    template <typename... Ts>
+    EntityHandle create(const Ts&... components);
+
+    // Stale and null handles are ignored
+    void destroy(EntityHandle handle);
+    bool isAlive(EntityHandle handle) const;
+
+    // Destroy every entity; archetypes and their chunk memory are released too
+    void clear();
+
+    size_t size() const { return liveCount; }
+    size_t getArchetypeCount() const { return archetypes.size(); }
+
+    // nullptr if the entity is gone or has no T. Valid until the next structural change.
+    template <typename T>
+    T* get(EntityHandle handle);
+    template <typename T>
+    const T* get(EntityHandle handle) const;
+
+    template <typename T>
+    bool has(EntityHandle handle) const;
+
+    // Overwrites T if the entity already has one, otherwise moves it to the archetype with T
+    template <typename T>
+    void add(EntityHandle handle, const T& component);
+
+    template <typename T>
+    void remove(EntityHandle handle);
+
+    // Entities that have all of Ts
+    template <typename... Ts>
+    size_t count() const;
+
+    // fn(first, count, handles, Ts*... columns) once per non-empty chunk holding
+    // all of Ts. first numbers the chunk's first row across the whole query, so
+    // rows map to [0, count<Ts...>()) in the same order on every call while no
+    // structural change happens. Ts may be const for read-only columns.
+    template <typename... Ts, typename Fn>
+    void forEachChunk(Fn&& fn);
+
+    // Same, with chunks spread over pool's threads; fn must be thread-safe
+    template <typename... Ts, typename Fn>
+    void parallelForEachChunk(ThreadPool& pool, Fn&& fn);
+
+    // fn(Ts&... components) for every entity holding all of Ts
+    template <typename... Ts, typename Fn>
+    void forEach(Fn&& fn);
+
+private:
+    struct Chunk {
+        std::unique_ptr<std::max_align_t[]> data;
+        uint32_t count;
+
+        uint8_t* bytes() const { return reinterpret_cast<uint8_t*>(data.get()); }
+    };
+
+    struct Archetype {
+        ComponentMask mask;
+        std::vector<uint32_t> components; // Ids present, ascending
+        uint32_t columnOffsets[MAX_COMPONENT_TYPES]; // Byte offset of each present component's array in a chunk
+        uint32_t capacity;                // Rows per chunk
+        std::vector<Chunk> chunks;
+        size_t entityCount;
+    };
+
+    struct Location {
+        uint32_t archetype; // Index into archetypes while live, next free index while free
+        uint32_t row;       // Row across the archetype's chunks
+        uint32_t generation;
+    };
+
+    // A chunk picked by a parallel query, with its first query-wide row
+    struct ChunkRef {
+        Archetype* archetype;
+        Chunk* chunk;
+        size_t first;
+    };
+
+    static constexpr uint32_t NO_FREE_HANDLE = 0xFFFFFFFFu;
+
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::vector<Location> locations;
+    uint32_t freeHandleHead{NO_FREE_HANDLE};
+    size_t liveCount{0};
+    std::vector<ChunkRef> queryChunks; // Scratch for parallelForEachChunk
+
+    static uint32_t registerComponent(size_t size, size_t alignment);
+    static size_t componentSize(uint32_t id);
+    static size_t componentAlignment(uint32_t id);
+
+    template <typename... Ts>
+    static ComponentMask maskOf();
+
+    template <typename T>
+    static T* column(const Archetype& archetype, const Chunk& chunk);
+
+    // Archetype index for exactly this component set, created on first use
+    uint32_t findOrCreateArchetype(ComponentMask mask);
+
+    // Handle for a new entity placed at a fresh row at the end of archetypeIndex
+    EntityHandle allocate(uint32_t archetypeIndex);
+
+    // Add a row for handle at the end of archetype (components unset); returns the row
+    uint32_t appendRow(Archetype& archetype, EntityHandle handle);
+
+    // Bytes of component id in row of archetype (which must have it)
+    uint8_t* componentAt(const Archetype& archetype, uint32_t row, uint32_t id) const;
+
+    // Take the row out of its archetype, moving the archetype's last row into it
+    void removeRow(uint32_t archetypeIndex, uint32_t row);
+
+    // Move a live entity to the archetype for newMask, keeping shared components
+    void changeArchetype(EntityHandle handle, ComponentMask newMask);
+
+    bool tryGetLocation(EntityHandle handle, const Location*& location) const;
+};
+
+template <typename T>
+uint32_t ArchetypeWorld::componentId() {
+    if constexpr (std::is_const<T>::value) {
+        return componentId<std::remove_const_t<T>>();
+    } else {
+        static_assert(std::is_trivially_copyable<T>::value, "components are moved with memcpy");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "chunk arrays are only max_align_t aligned");
+
+        static const uint32_t id = registerComponent(sizeof(T), alignof(T));
+        return id;
+    }
+}
+
+template <typename... Ts>
+ComponentMask ArchetypeWorld::maskOf() {
+    ComponentMask mask = 0;
+    ((mask |= ComponentMask(1) << componentId<Ts>()), ...);
+    return mask;
+}
+
+template <typename T>
+T* ArchetypeWorld::column(const Archetype& archetype, const Chunk& chunk) {
+    return reinterpret_cast<T*>(chunk.bytes() + archetype.columnOffsets[componentId<T>()]);
+}
+
+template <typename... Ts>
+EntityHandle ArchetypeWorld::create(const Ts&... components) {
+    const uint32_t archetypeIndex = findOrCreateArchetype(maskOf<Ts...>());
+    EntityHandle handle = allocate(archetypeIndex);
+
+    const Archetype& archetype = *archetypes[archetypeIndex];
+    const uint32_t row = locations[handle.index()].row;
+    ((*reinterpret_cast<Ts*>(componentAt(archetype, row, componentId<Ts>())) = components), ...);
+    return handle;
+}
+
+template <typename T>
+T* ArchetypeWorld::get(EntityHandle handle) {
+    return const_cast<T*>(static_cast<const ArchetypeWorld*>(this)->get<T>(handle));
+}
+
+template <typename T>
+const T* ArchetypeWorld::get(EntityHandle handle) const {
+    const Location* location;
+    if (!tryGetLocation(handle, location)) return nullptr;
+
+    const uint32_t id = componentId<T>();
+    const Archetype& archetype = *archetypes[location->archetype];
+    if (!(archetype.mask & (ComponentMask(1) << id))) return nullptr;
+    return reinterpret_cast<const T*>(componentAt(archetype, location->row, id));
+}
+
+template <typename T>
+bool ArchetypeWorld::has(EntityHandle handle) const {
+    return get<T>(handle) != nullptr;
+}
+
+template <typename T>
+void ArchetypeWorld::add(EntityHandle handle, const T& component) {
+    const Location* location;
+    if (!tryGetLocation(handle, location)) return;
+
+    const ComponentMask bit = ComponentMask(1) << componentId<T>();
+    if (!(archetypes[location->archetype]->mask & bit)) {
+        changeArchetype(handle, archetypes[location->archetype]->mask | bit);
+    }
+    *get<T>(handle) = component;
+}
+
+template <typename T>
+void ArchetypeWorld::remove(EntityHandle handle) {
+    const Location* location;
+    if (!tryGetLocation(handle, location)) return;
+
+    const ComponentMask bit = ComponentMask(1) << componentId<T>();
+    if (archetypes[location->archetype]->mask & bit) {
+        changeArchetype(handle, archetypes[location->archetype]->mask & ~bit);
+    }
+}
+
+template <typename... Ts>
+size_t ArchetypeWorld::count() const {
+    const ComponentMask mask = maskOf<Ts...>();
+    size_t total = 0;
+    for (const auto& archetype : archetypes) {
+        if ((archetype->mask & mask) == mask) {
+            total += archetype->entityCount;
+        }
+    }
+    return total;
+}
+
+template <typename... Ts, typename Fn>
+void ArchetypeWorld::forEachChunk(Fn&& fn) {
+    const ComponentMask mask = maskOf<Ts...>();
+    size_t first = 0;
+    for (const auto& archetype : archetypes) {
+        if ((archetype->mask & mask) != mask) continue;
+
+        for (const Chunk& chunk : archetype->chunks) {
+            fn(first, static_cast<size_t>(chunk.count), reinterpret_cast<const EntityHandle*>(chunk.bytes()),
+               column<Ts>(*archetype, chunk)...);
+            first += chunk.count;
+        }
+    }
+}
+
+template <typename... Ts, typename Fn>
+void ArchetypeWorld::parallelForEachChunk(ThreadPool& pool, Fn&& fn) {
+    const ComponentMask mask = maskOf<Ts...>();
+    queryChunks.clear();
+    size_t first = 0;
+    for (const auto& archetype : archetypes) {
+        if ((archetype->mask & mask) != mask) continue;
+
+        for (Chunk& chunk : archetype->chunks) {
+            queryChunks.push_back({archetype.get(), &chunk, first});
+            first += chunk.count;
+        }
+    }
+
+    pool.parallelFor(queryChunks.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const ChunkRef& ref = queryChunks[i];
+            fn(ref.first, static_cast<size_t>(ref.chunk->count),
+               reinterpret_cast<const EntityHandle*>(ref.chunk->bytes()), column<Ts>(*ref.archetype, *ref.chunk)...);
+        }
+    });
+}
+
+template <typename... Ts, typename Fn>
+void ArchetypeWorld::forEach(Fn&& fn) {
+    forEachChunk<Ts...>([&](size_t, size_t count, const EntityHandle*, Ts*... columns) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(columns[i]...);
+        }
+    });
+}
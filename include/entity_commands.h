@@ -0,0 +1,41 @@
+#pragma once
+
+#include "entity_handle.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct Entity;
+
+/**
+ * EntityCommandBuffer - Spawns and despawns deferred to a sync point
+ *
+ * Recording is thread-safe, so entity updates running on worker threads can
+ * queue structural changes; EntityManager applies them in one batch after
+ * the tick. Despawns are applied first (duplicates and stale handles are
+ * ignored), then spawns in ascending order key.
+ *
+ * Spawns recorded concurrently should pass the recording entity's slot as
+ * the order key so the applied order does not depend on thread timing.
+ */
+class EntityCommandBuffer {
+public:
+    void spawn(std::shared_ptr<Entity> entity, uint32_t order = 0);
+    void despawn(EntityHandle handle);
+
+    bool empty() const;
+    void clear();
+
+private:
+    struct SpawnCommand {
+        std::shared_ptr<Entity> entity;
+        uint32_t order;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<SpawnCommand> spawns;
+    std::vector<EntityHandle> despawns;
+
+    friend class EntityManager;
+};
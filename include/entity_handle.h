@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * EntityHandle - 32-bit generational reference to an entity
+ *
+ * The low 20 bits index the manager's handle table and the high 12 bits hold
+ * the generation of that table entry. Freeing an entity bumps the generation,
+ * so handles held past the entity's lifetime resolve to nothing instead of
+ * dangling. The all-zero value is the null handle; generations start at 1.
+ */
+struct EntityHandle {
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+    uint32_t value{0};
+
+    EntityHandle() = default;
+    EntityHandle(uint32_t index, uint32_t generation)
+        : value((generation << INDEX_BITS) | (index & INDEX_MASK)) {}
+
+    uint32_t index() const { return value & INDEX_MASK; }
+    uint32_t generation() const { return value >> INDEX_BITS; }
+    bool isValid() const { return value != 0; }
+
+    bool operator==(const EntityHandle& other) const { return value == other.value; }
+    bool operator!=(const EntityHandle& other) const { return value != other.value; }
+};
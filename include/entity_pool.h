@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/**
+ * SlabPool - Fixed-size block allocator backed by large slabs
+ *
+ * Blocks are carved out of slabs of blocksPerSlab blocks each and recycled
+ * through an intrusive free list, so allocate and deallocate are O(1) and
+ * steady-state spawning never reaches the system allocator. Slabs are only
+ * released when the pool is destroyed.
+ *
+ * Allocation and release take a mutex: entity updates on worker threads may
+ * spawn, and the last reference to a pooled entity can drop on any thread.
+ */
+class SlabPool {
+public:
+    SlabPool(size_t blockSize, size_t blockAlignment, size_t blocksPerSlab = 256);
+    ~SlabPool();
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    void* allocate();
+    void deallocate(void* block);
+
+    size_t getBlockSize() const { return blockSize; }
+    size_t getLiveBlockCount() const { return liveBlocks; }
+    size_t getSlabCount() const { return slabs.size(); }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    size_t blockSize;
+    size_t blockAlignment;
+    size_t blocksPerSlab;
+    size_t liveBlocks;
+
+    std::mutex mutex;
+    FreeBlock* freeList;
+    std::vector<void*> slabs;
+
+    void addSlab();
+};
+
+/**
+ * PoolAllocator - Standard allocator that draws single objects from a SlabPool
+ *
+ * Meant for std::allocate_shared: the shared_ptr control block and the entity
+ * then live in one pooled block. Each rebound type gets its own pool, sized
+ * for that type. Array allocations fall back to the global operator new.
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        if (count == 1) {
+            return static_cast<T*>(pool().allocate());
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        if (count == 1) {
+            pool().deallocate(pointer);
+        } else {
+            ::operator delete(pointer, std::align_val_t(alignof(T)));
+        }
+    }
+
+    static SlabPool& pool() {
+        // Intentionally leaked: pooled shared_ptrs may outlive static destruction
+        static SlabPool* instance = new SlabPool(sizeof(T), alignof(T));
+        return *instance;
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) { return false; }
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Entity snapshot format - Binary image of an EntityManager
+ *
+ * Layout (native byte order, checked on load):
+ *   SnapshotHeader
+ *   then one section per array, each starting on a SNAPSHOT_ALIGNMENT boundary:
+ *     storage arrays in EntityStorage order (positions, previousPositions,
+ *     targetPositions, radii, moving, active, kinds, stillTicks, sleeping)
+ *     SnapshotEntityRecord per slot (cold fields and concrete type)
+ *     handle table entries (slot, generation)
+ *     player handles, in the order the PCs were added
+ *
+ * The sections mirror the in-memory arrays, so saving is a run of flat
+ * writes and loading is one bulk copy per array. Handles are stored as-is,
+ * so handles held in saved entities (e.g. enemy targets) stay valid.
+ * Timed action states are rescheduled on load; other gameplay timers are
+ * not saved. Enemy paths are not saved either: chasing enemies search again
+ * after a load, steering by their saved seek direction until the path comes
+ * back.
+ */
+
+constexpr uint32_t SNAPSHOT_VERSION = 3;
+constexpr uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+constexpr size_t SNAPSHOT_ALIGNMENT = 16;
+
+// Concrete entity class, so loading can recreate the right type
+enum class SnapshotEntityType : uint8_t {
+    Entity,
+    PlayerEntity,
+    EnemyEntity,
+    BasicShooterEnemy
+};
+
+struct SnapshotHeader {
+    char magic[4]; // "ARPS"
+    uint32_t version;
+    uint32_t byteOrder; // SNAPSHOT_BYTE_ORDER as written
+    uint32_t entityCount;
+    uint32_t handleCount;
+    uint32_t playerCount;
+    uint32_t freeHandleHead;
+    uint32_t reserved;
+    uint64_t fileSize;
+};
+
+struct SnapshotEntityRecord {
+    uint64_t stateTicksRemaining; // Until actionState ends, 0 if it does not
+    glm::vec3 rotation;
+    glm::vec3 scale;
+    glm::vec3 color;
+
+    // MobEntity pools and base stats (stat modifiers are not saved)
+    float health;
+    float maxHealth;
+    float energy;
+    float maxEnergy;
+    float movementSpeed;
+    float attackSpeed;
+
+    // BasicShooterEnemy decision state
+    glm::vec3 moveDirection;
+    glm::vec3 seekDirection;
+    float fireCooldown;
+    uint32_t target;
+
+    SnapshotEntityType type;
+    uint8_t actionState;
+    uint8_t intent;
+    uint8_t reserved;
+};
+
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "snapshot header must be flat");
+static_assert(std::is_trivially_copyable<SnapshotEntityRecord>::value, "snapshot records must be flat");
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Compact tag for the concrete entity family, stored next to the hot data
+enum class EntityKind : uint8_t {
+    Basic,  // Plain renderable entity
+    Player, // PlayerEntity
+    Enemy   // EnemyEntity and subclasses
+};
+
+inline bool isMobKind(EntityKind kind) {
+    return kind != EntityKind::Basic;
+}
+
+// Set of entity kinds, for filtering spatial queries
+using EntityKindMask = uint8_t;
+
+constexpr EntityKindMask kindMask(EntityKind kind) {
+    return static_cast<EntityKindMask>(1u << static_cast<uint8_t>(kind));
+}
+
+constexpr EntityKindMask ANY_MOB_KIND = kindMask(EntityKind::Player) | kindMask(EntityKind::Enemy);
+
+// Hot state of a single entity, used to move it in and out of storage
+struct EntityHotState {
+    glm::vec3 position{0.0f, 0.0f, 0.0f};
+    glm::vec3 targetPosition{0.0f, 0.0f, 0.0f};
+    float radius{0.5f};
+    bool moving{false};
+    bool active{true};
+    EntityKind kind{EntityKind::Basic};
+};
+
+/**
+ * EntityStorage - Structure-of-arrays store for per-tick entity data
+ *
+ * Slot i of every array belongs to the same entity. Only the fields that the
+ * movement and collision loops touch live here; colors, stats and other cold
+ * data stay on the Entity objects, which act as views into these arrays.
+ *
+ * Removal swaps the last slot into the hole, so slots are always dense.
+ * Sleep state is not part of EntityHotState; an entity always enters storage
+ * awake.
+ *
+ * During a parallel tick positions are double-buffered: everyone reads the
+ * frozen previous-tick positions and each entity writes only its own slot of
+ * nextPositions, which is swapped in once the tick is done.
+ */
+struct EntityStorage {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> previousPositions; // Positions at the start of the last tick, for render interpolation
+    std::vector<glm::vec3> targetPositions;
+    std::vector<float> radii;
+    std::vector<uint8_t> moving;
+    std::vector<uint8_t> active;
+    std::vector<EntityKind> kinds;
+
+    // Sleep tracking: ticks in a row without movement (saturating) and the sleeping flag
+    std::vector<uint8_t> stillTicks;
+    std::vector<uint8_t> sleeping;
+
+    // Last tick's movement per second; only filled (by captureVelocities) when a
+    // steering mode needs it, and not kept in step with push/swapRemove
+    std::vector<glm::vec3> velocities;
+
+    // Write buffer for positions while doubleBuffered is set
+    std::vector<glm::vec3> nextPositions;
+    bool doubleBuffered{false};
+
+    // Bumped by every setPosition outside a parallel tick, so the spatial grid
+    // can tell positions changed since it was built; never reset
+    uint64_t positionEdits{0};
+
+    glm::vec3& positionForWrite(uint32_t slot) {
+        return doubleBuffered ? nextPositions[slot] : positions[slot];
+    }
+
+    void setPosition(uint32_t slot, const glm::vec3& position) {
+        positionForWrite(slot) = position;
+        if (!doubleBuffered) positionEdits++;
+    }
+
+    // Start/finish a double-buffered tick
+    void beginDoubleBuffer();
+    void endDoubleBuffer();
+
+    // Remember where everything was before this tick moves it
+    void capturePreviousPositions() { previousPositions = positions; }
+
+    // Velocities from the last tick's movement; call before capturePreviousPositions
+    void captureVelocities(float deltaTime);
+
+    uint32_t size() const { return static_cast<uint32_t>(positions.size()); }
+
+    uint32_t push(const EntityHotState& state);
+    EntityHotState read(uint32_t slot) const;
+
+    // Move the last slot into the given slot and shrink by one.
+    // Returns the old index of the moved slot (equal to slot if it was last).
+    uint32_t swapRemove(uint32_t slot);
+
+    void reserve(size_t count);
+    void clear();
+};
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * EventBus - Batched gameplay events with per-thread append buffers
+ *
+ * Features:
+ * - publish() appends to a buffer owned by the calling thread, so producers
+ *   on worker threads never take a lock or touch a shared cache line; a
+ *   thread claims its buffer under a lock on first use and remembers it in
+ *   a small thread-local cache (a thread that publishes to more buses than
+ *   the cache holds finds its own buffer again under the same lock)
+ * - dispatch() is the sync point: it drains every thread's buffers, merges
+ *   each event type's events in ascending order key, and hands each
+ *   subscriber the whole batch at once (types in the order they were first
+ *   subscribed)
+ * - Events nobody subscribed to are dropped at dispatch; producers can ask
+ *   isWanted<T>() to skip building them at all
+ *
+ * Events from one thread keep their publish order within an order key, so
+ * passing the producing entity's slot as the key makes batches independent
+ * of which worker ran which entity. Events published by handlers during
+ * dispatch are delivered at the next dispatch.
+ *
+ * Event types must be copyable; at most MAX_EVENT_TYPES types (one more
+ * aborts) and MAX_PRODUCERS publishing threads per bus (any further threads
+ * share one locked buffer). subscribe, dispatch and clear must not run while
+ * other threads publish.
+ */
+class EventBus {
+public:
+    static constexpr size_t MAX_EVENT_TYPES = 32;
+    static constexpr size_t MAX_PRODUCERS = 64;
+
+    struct Stats {
+        uint64_t published;  // Events drained at dispatch, wanted or not
+        uint64_t dispatched; // Events handed to at least one subscriber
+        uint32_t producers;  // Threads with a buffer of their own
+    };
+
+    EventBus();
+    ~EventBus() = default;
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    // Process-wide id of event type T, assigned on first use
+    template <typename T>
+    static uint32_t eventTypeId();
+
+    // Thread-safe and lock-free once the calling thread has published before
+    template <typename T>
+    void publish(const T& event, uint32_t order = 0);
+
+    // handler(events, count) gets every T published since the last dispatch
+    template <typename T>
+    void subscribe(std::function<void(const T* events, size_t count)> handler);
+
+    template <typename T>
+    bool isWanted() const {
+        return wanted[eventTypeId<T>()];
+    }
+
+    void dispatch();
+
+    // Drop every buffered event (subscribers stay)
+    void clear();
+
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    // One thread's buffered events of one type
+    struct BufferBase {
+        virtual ~BufferBase() = default;
+        virtual size_t size() const = 0;
+        virtual void clear() = 0;
+    };
+
+    template <typename T>
+    struct Buffer : BufferBase {
+        struct Record {
+            uint32_t order;
+            T event;
+        };
+        std::vector<Record> records;
+
+        size_t size() const override { return records.size(); }
+        void clear() override { records.clear(); }
+    };
+
+    struct Producer {
+        std::thread::id owner;
+        std::unique_ptr<BufferBase> buffers[MAX_EVENT_TYPES];
+    };
+
+    // Merges one type's buffers and calls its subscribers
+    struct ChannelBase {
+        virtual ~ChannelBase() = default;
+        virtual void drain(Producer* const* producers, size_t producerCount) = 0;
+        virtual size_t deliver() = 0;
+    };
+
+    template <typename T>
+    struct Channel : ChannelBase {
+        std::vector<std::function<void(const T*, size_t)>> handlers;
+        std::vector<typename Buffer<T>::Record> merged;
+        std::vector<T> batch;
+
+        void drain(Producer* const* producers, size_t producerCount) override;
+        size_t deliver() override;
+    };
+
+    const uint64_t busId; // Never reused, so stale thread-local lookups cannot match a new bus
+
+    std::mutex producerMutex; // Held while claiming or looking up a producer slot
+    std::atomic<uint32_t> producerCount; // Claimed slots of producers
+    std::unique_ptr<Producer> producers[MAX_PRODUCERS];
+    std::mutex overflowMutex;
+    Producer overflow; // Shared by threads beyond MAX_PRODUCERS, under overflowMutex
+
+    std::unique_ptr<ChannelBase> channels[MAX_EVENT_TYPES];
+    bool wanted[MAX_EVENT_TYPES];
+    std::vector<uint32_t> channelOrder; // Type ids in the order first subscribed
+    std::vector<Producer*> drainList;   // Scratch for dispatch
+
+    uint64_t publishedCount;
+    uint64_t dispatchedCount;
+
+    static uint32_t registerEventType();
+
+    // The calling thread's producer, or nullptr once all have been claimed
+    Producer* localProducer();
+
+    template <typename T>
+    static Buffer<T>& bufferFor(Producer& producer);
+};
+
+template <typename T>
+uint32_t EventBus::eventTypeId() {
+    static const uint32_t id = registerEventType();
+    return id;
+}
+
+template <typename T>
+EventBus::Buffer<T>& EventBus::bufferFor(Producer& producer) {
+    std::unique_ptr<BufferBase>& buffer = producer.buffers[eventTypeId<T>()];
+    if (!buffer) {
+        buffer = std::make_unique<Buffer<T>>();
+    }
+    return static_cast<Buffer<T>&>(*buffer);
+}
+
+template <typename T>
+void EventBus::publish(const T& event, uint32_t order) {
+    Producer* producer = localProducer();
+    if (producer) {
+        bufferFor<T>(*producer).records.push_back({order, event});
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(overflowMutex);
+    bufferFor<T>(overflow).records.push_back({order, event});
+}
+
+template <typename T>
+void EventBus::subscribe(std::function<void(const T* events, size_t count)> handler) {
+    const uint32_t id = eventTypeId<T>();
+    if (!channels[id]) {
+        channels[id] = std::make_unique<Channel<T>>();
+        channelOrder.push_back(id);
+        wanted[id] = true;
+    }
+    static_cast<Channel<T>&>(*channels[id]).handlers.push_back(std::move(handler));
+}
+
+template <typename T>
+void EventBus::Channel<T>::drain(Producer* const* producers, size_t producerCount) {
+    const uint32_t id = eventTypeId<T>();
+    merged.clear();
+    for (size_t p = 0; p < producerCount; ++p) {
+        BufferBase* buffer = producers[p]->buffers[id].get();
+        if (!buffer) continue;
+
+        auto& records = static_cast<Buffer<T>*>(buffer)->records;
+        merged.insert(merged.end(), records.begin(), records.end());
+        records.clear();
+    }
+
+    // Stable, so one producer's events keep their order under a shared key.
+    // Producers mostly publish in key order already, so check before sorting.
+    auto byOrder = [](const auto& a, const auto& b) {
+        return a.order < b.order;
+    };
+    if (!std::is_sorted(merged.begin(), merged.end(), byOrder)) {
+        std::stable_sort(merged.begin(), merged.end(), byOrder);
+    }
+    batch.clear();
+    for (const auto& record : merged) {
+        batch.push_back(record.event);
+    }
+}
+
+template <typename T>
+size_t EventBus::Channel<T>::deliver() {
+    if (batch.empty()) return 0;
+    for (const auto& handler : handlers) {
+        handler(batch.data(), batch.size());
+    }
+    return batch.size();
+}
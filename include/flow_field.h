@@ -0,0 +1,77 @@
+#pragma once
+
+#include "entity_handle.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * FlowField - Dijkstra map toward a set of goals over a bounded XZ grid
+ *
+ * Features:
+ * - One multi-source Dijkstra pass (8-connected, octile costs, bucket queue)
+ *   per goal change
+ * - Every cell stores its distance to, direction toward and index of the
+ *   nearest goal, so followers sample it in O(1) regardless of their number
+ * - The grid follows the goals' centroid in coarse steps; followers outside
+ *   it get no sample and fall back to their own goal search
+ *
+ * The field is only recomputed when a goal crosses into another cell (or the
+ * grid recenters), so a party standing still costs nothing per tick.
+ */
+class FlowField {
+public:
+    struct Goal {
+        EntityHandle handle;
+        glm::vec3 position;
+    };
+
+    struct Sample {
+        glm::vec3 direction; // Unit XZ direction down the distance gradient (zero on a goal cell)
+        float distance;      // Path distance to the nearest goal
+        uint32_t goal;       // Index into getGoals()
+    };
+
+    explicit FlowField(float cellSize = 1.0f, int32_t gridSize = 128);
+
+    // Recompute if any goal changed cell; returns true if the field was rebuilt
+    bool update(const std::vector<Goal>& goals);
+    void clear();
+
+    // Bilinear sample at position; false if outside the grid or no goal reaches it
+    bool sample(const glm::vec3& position, Sample& result) const;
+
+    const std::vector<Goal>& getGoals() const { return goals; }
+    float getCellSize() const { return cellSize; }
+    uint64_t getRebuildCount() const { return rebuildCount; }
+
+private:
+    static constexpr uint8_t NO_GOAL = 0xFF;
+    static constexpr int32_t RECENTER_STEP = 16; // Origin moves in multiples of this many cells
+
+    float cellSize;
+    float inverseCellSize;
+    int32_t gridSize;
+
+    // World-space cell coordinate of grid cell (0, 0)
+    int32_t originX;
+    int32_t originZ;
+
+    std::vector<Goal> goals;
+    std::vector<int32_t> goalCells; // Grid index of each goal at the last rebuild, -1 if off-grid
+
+    // Per grid cell, row-major in Z
+    std::vector<float> distances;
+    std::vector<glm::vec2> directions;
+    std::vector<uint8_t> nearestGoal;
+
+    // Dijkstra scratch: integer path costs and the bucket queue, kept to reuse capacity
+    std::vector<uint32_t> costs;
+    std::vector<std::vector<int32_t>> buckets;
+
+    uint64_t rebuildCount;
+
+    int32_t cellCoord(float value) const;
+    int32_t gridIndex(int32_t cellX, int32_t cellZ) const;
+    void rebuild();
+};
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "renderer.h"
-#include "entity.h"
+#include "simulation.h"
 #include "input.h"
+#include "input_record.h"
 #include <memory>
+#include <string>
 #include <vector>
 
 class Game {
@@ -11,23 +13,30 @@ public:
     Game();
     ~Game();
 
+    // Record every input of the session to path (call before initialize)
+    void setRecordPath(const std::string& path) { recordPath = path; }
+
     bool initialize();
     void run();
     void shutdown();
 
 private:
     void update(float deltaTime);
-    void render();
+    void updateCamera(float frameTime, float alpha);
+    void render(float alpha);
     void handleInput();
 
     std::unique_ptr<Renderer> renderer;
     std::unique_ptr<InputManager> inputManager;
-    std::unique_ptr<EntityManager> entityManager;
+    std::unique_ptr<Simulation> simulation;
+
+    // Input recording, for reproducing a session headless with sim_replay
+    std::string recordPath;
+    std::unique_ptr<InputRecorder> recorder;
 
     // Party system
     static constexpr size_t MIN_PARTY_SIZE = 1;
     static constexpr size_t MAX_PARTY_SIZE = 10;
-    std::vector<std::shared_ptr<PlayerEntity>> party;
     size_t activePlayerIndex;
 
     // Camera
@@ -46,11 +55,15 @@ private:
     size_t transitionTargetIndex;
 
     void startCameraTransition(size_t targetIndex);
-    void updateCameraTransition(float deltaTime);
+    void updateCameraTransition(float deltaTime, float alpha);
 
     // Timing
     double lastFrameTime;
 
+    // Fixed-step simulation, decoupled from the render rate
+    static constexpr int MAX_SIM_STEPS_PER_FRAME = 5; // Beyond this, drop time instead of catching up
+    double simAccumulator;
+
     // Window size tracking for resize handling
     int lastWindowWidth;
     int lastWindowHeight;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "entity_handle.h"
+#include "timer_wheel.h"
+#include <glm/glm.hpp>
+
+// Gameplay events EntityManager publishes on its EventBus (see
+// EntityManager::getEvents). Handles may already be stale by the time the
+// event is dispatched.
+
+// A moving mob ran into another: its sweep stopped at other, or it overlapped
+// other after the step and slid along or was pushed out
+struct CollisionEvent {
+    EntityHandle mover;
+    EntityHandle other;
+    glm::vec3 position; // Where the mover ended up
+};
+
+// A projectile hit a mob and took health off it
+struct DamageEvent {
+    EntityHandle source; // Whoever fired (may be null)
+    EntityHandle target;
+    float amount;
+    float healthLeft;
+    glm::vec3 position;  // Point of impact
+};
+
+// A mob's health reached zero; it stays in the manager until someone removes it
+struct DeathEvent {
+    EntityHandle entity;
+    EntityHandle killer; // Source of the killing blow (may be null)
+    glm::vec3 position;
+};
+
+// What a timer on EntityManager::getTimers() is for; passed as its tag
+enum class TimerTag : uint32_t {
+    ActionState,    // End of a timed actionState; handled by the manager, never published
+    Cooldown,       // data: which ability is ready again
+    Buff,           // data: source of the StatBlock modifiers to remove
+    DamageOverTime  // Periodic; data: damage per tick
+};
+
+// A gameplay timer came due during the tick
+struct TimerEvent {
+    TimerHandle timer; // Still pending if the timer is periodic
+    EntityHandle entity;
+    TimerTag tag;
+    uint32_t data;
+};
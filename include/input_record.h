@@ -0,0 +1,72 @@
+#pragma once
+
+#include "entity.h"
+#include "sim_input.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Input recording - Compact binary log of everything that drives a simulation
+ *
+ * A recording holds the RNG seed and update mode the simulation was created
+ * with, followed by every SimCommand tagged with the tick it was applied on.
+ * Replaying it into a fresh Simulation (same build, same party setup)
+ * reproduces the run tick for tick.
+ *
+ * File layout, all little-endian:
+ *   header: "ARPI", u32 version, u64 seed, u8 update mode, 3 bytes padding
+ *   record: u32 tick, u8 type, then per type
+ *           MoveTo: u8 party index, f32 x, f32 y, f32 z
+ *           Stop:   u8 party index
+ *           SpawnEnemy: nothing
+ *   end:    u32 total tick count, u8 0xFF
+ */
+class InputRecorder {
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    bool open(const std::string& path, uint64_t seed, UpdateMode mode);
+
+    // Log the commands applied at the start of tick
+    void record(uint64_t tick, const std::vector<SimCommand>& commands);
+
+    // Write the end marker with the number of ticks run and close the file
+    void close(uint64_t tickCount);
+
+    bool isOpen() const { return file != nullptr; }
+
+private:
+    FILE* file;
+};
+
+class InputReplay {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    bool load(const std::string& path);
+
+    uint64_t getSeed() const { return seed; }
+    UpdateMode getUpdateMode() const { return updateMode; }
+    uint64_t getTickCount() const { return tickCount; }
+    size_t getCommandCount() const { return commands.size(); }
+
+    // Append the commands recorded for tick, in their original order
+    void commandsForTick(uint64_t tick, std::vector<SimCommand>& results) const;
+
+private:
+    struct TickCommand {
+        uint64_t tick;
+        SimCommand command;
+    };
+
+    uint64_t seed{0};
+    UpdateMode updateMode{UpdateMode::Parallel};
+    uint64_t tickCount{0};
+    std::vector<TickCommand> commands; // Sorted by tick
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "spatial_grid.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Collision steps shared by MobEntity and MobMovementSystem.
+//
+// grid buckets the bodies by slot; positions and radii are indexed by the same
+// slots and slot is the moving mob's own. Each step only reads them, so a tick
+// can run every mob in parallel against one frozen set of bodies.
+
+// Someone the mover ran into, and where the mover was when it happened
+struct MobContact {
+    uint32_t other;
+    glm::vec3 position;
+};
+
+// Sweep the mob's circle from start toward desiredPosition, stopping just short
+// of the first body hit and sliding along it once. Each hit is appended to
+// contacts if given.
+glm::vec3 sweepMobToFirstContact(const SpatialHashGrid& grid, const std::vector<float>& radii, uint32_t slot,
+                                 const glm::vec3& start, const glm::vec3& desiredPosition,
+                                 std::vector<MobContact>* contacts = nullptr);
+
+// Slide along every body overlapping desiredPosition, then push out of any still
+// overlapped. Each overlapped body is appended to contacts (at the returned
+// position) if given.
+glm::vec3 resolveMobCollisions(const SpatialHashGrid& grid, const std::vector<glm::vec3>& positions,
+                               const std::vector<float>& radii, uint32_t slot, const glm::vec3& desiredPosition,
+                               std::vector<MobContact>* contacts = nullptr);
+
+// Push position away from bodies closer than their preferred distance
+glm::vec3 applyMobSeparation(const SpatialHashGrid& grid, const std::vector<glm::vec3>& positions,
+                             const std::vector<float>& radii, uint32_t slot, const glm::vec3& position,
+                             float deltaTime);
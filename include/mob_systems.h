@@ -0,0 +1,69 @@
+#pragma once
+
+#include "archetype_world.h"
+#include "entity.h"
+#include "entity_storage.h"
+#include "nav_grid.h"
+#include "spatial_grid.h"
+#include "thread_pool.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+
+// Mob components for ArchetypeWorld
+
+struct PositionComponent {
+    glm::vec3 value;
+};
+
+// Where the mob is walking and how fast (MobEntity::moveTo / getMovementSpeed)
+struct MotionComponent {
+    glm::vec3 target;
+    float speed;
+    uint8_t moving;
+};
+
+// Collision circle and which side the mob is on
+struct BodyComponent {
+    float radius;
+    EntityKind kind;
+};
+
+/**
+ * MobMovementSystem - MobEntity movement and collision as an ArchetypeWorld system
+ *
+ * Features:
+ * - Runs over every entity with Position, Motion and Body components: steps
+ *   toward the motion target, resolves collisions with sliding (sweeping
+ *   first in CollisionMode::Continuous), applies separation and slides along
+ *   blocked nav grid cells, with the same code as MobEntity::update (see
+ *   mob_collision.h)
+ * - Each update gathers the bodies into a frozen EntityStorage (positions,
+ *   radii, kinds) and rebuilds a SpatialHashGrid over it, so every mob reads
+ *   last tick's positions and writes only its own; results match
+ *   EntityManager's parallel mode and do not depend on the thread count
+ * - With a ThreadPool, whole chunks are handed to its threads
+ *
+ * Mobs here do not sleep; every mob is stepped every tick.
+ */
+class MobMovementSystem {
+public:
+    explicit MobMovementSystem(CollisionMode collisionMode = CollisionMode::Continuous);
+
+    void update(ArchetypeWorld& world, float deltaTime, const NavGrid* navGrid = nullptr,
+                ThreadPool* pool = nullptr);
+
+    void setCollisionMode(CollisionMode mode) { collisionMode = mode; }
+    CollisionMode getCollisionMode() const { return collisionMode; }
+
+    // Bodies as of the start of the last update; indices are query rows
+    const EntityStorage& getFrozen() const { return frozen; }
+    const SpatialHashGrid& getGrid() const { return grid; }
+
+private:
+    CollisionMode collisionMode;
+    EntityStorage frozen;
+    SpatialHashGrid grid;
+
+    // One mob's step; row is its index into frozen
+    glm::vec3 stepMob(uint32_t row, MotionComponent& motion, float deltaTime, const NavGrid* navGrid) const;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * NavGrid - Walkability of the level as a bounded XZ cell grid
+ *
+ * Features:
+ * - One blocked flag per cell, centered on the world origin
+ * - Segment traversal that reports every cell a straight line touches
+ *   (both neighbors when it passes exactly through a corner)
+ * - Log of the cells whose walkability changed, for consumers that cache
+ *   results derived from the grid (see PathService)
+ *
+ * Cells outside the grid count as open for line of sight but are not
+ * searched by path queries.
+ */
+class NavGrid {
+public:
+    explicit NavGrid(float cellSize = 1.0f, int32_t width = 128, int32_t height = 128);
+
+    // Cell index containing position, or -1 outside the grid
+    int32_t cellIndex(const glm::vec3& position) const;
+    int32_t cellIndex(int32_t x, int32_t z) const;
+    glm::vec3 cellCenter(int32_t index) const;
+    int32_t cellX(int32_t index) const { return index % width; }
+    int32_t cellZ(int32_t index) const { return index / width; }
+
+    void setBlocked(int32_t index, bool blocked);
+    void setBlocked(const glm::vec3& position, bool blocked);
+    // Every cell overlapping the XZ rectangle between two corners
+    void setBlockedRect(const glm::vec3& corner, const glm::vec3& oppositeCorner, bool blocked);
+    void clearBlocked();
+
+    bool isBlocked(int32_t index) const { return blocked[index] != 0; }
+    bool isWalkable(const glm::vec3& position) const;
+    bool hasObstacles() const { return blockedCount > 0; }
+
+    // Where a move ends up if blocked cells are solid:
+    // the move itself, else its X or Z part alone, else no move
+    glm::vec3 slideToWalkable(const glm::vec3& from, const glm::vec3& to) const;
+
+    // True if the straight segment touches no blocked cell
+    bool lineOfSight(const glm::vec3& start, const glm::vec3& end) const;
+
+    // Append the index of every grid cell the segment touches, in order
+    void appendCellsOnSegment(const glm::vec3& start, const glm::vec3& end, std::vector<int32_t>& cells) const;
+
+    // Cells whose blocked flag changed since clearChangedCells (may repeat)
+    const std::vector<int32_t>& getChangedCells() const { return changedCells; }
+    void clearChangedCells() { changedCells.clear(); }
+
+    float getCellSize() const { return cellSize; }
+    int32_t getWidth() const { return width; }
+    int32_t getHeight() const { return height; }
+    int32_t getCellCount() const { return width * height; }
+
+private:
+    float cellSize;
+    float inverseCellSize;
+    int32_t width;
+    int32_t height;
+
+    // World-space cell coordinate of grid cell (0, 0)
+    int32_t originX;
+    int32_t originZ;
+
+    std::vector<uint8_t> blocked; // Per cell, row-major in Z
+    uint32_t blockedCount;
+    std::vector<int32_t> changedCells;
+
+    // Visit cells along the segment (grid coordinates, possibly off-grid) until visit returns false
+    template <typename Visit>
+    bool traverse(const glm::vec3& start, const glm::vec3& end, Visit visit) const;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// Another agent as seen by the solver, on the ground plane (x, z)
+struct OrcaNeighbor {
+    glm::vec2 position;
+    glm::vec2 velocity;
+    float radius;
+    float responsibility; // Share of the avoidance this agent takes on: 0.5 reciprocal, 1 if the other will not react
+};
+
+/**
+ * ORCA - Optimal reciprocal collision avoidance velocity solver
+ *
+ * Every neighbor contributes one half-plane of velocities that stay clear of
+ * it for timeHorizon seconds, assuming it keeps its current velocity while
+ * this agent takes on its share of the correction. The new velocity is the
+ * one closest to the preferred velocity inside all half-planes and the
+ * maxSpeed circle, found with an incremental 2D linear program. When the
+ * half-planes leave no room (dense crowds), the velocity that violates them
+ * least is used instead.
+ *
+ * Agents that already overlap are pushed apart within deltaTime. Results only
+ * depend on the inputs and their order.
+ *
+ * The solver is adapted from the RVO2 Library (Apache-2.0); see NOTICE.
+ */
+glm::vec2 solveOrcaVelocity(const glm::vec2& position, const glm::vec2& velocity, float radius,
+                            const glm::vec2& preferredVelocity, float maxSpeed,
+                            const OrcaNeighbor* neighbors, size_t count,
+                            float timeHorizon, float deltaTime);
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "nav_grid.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * PathHierarchy - HPA* abstraction of a NavGrid
+ *
+ * Features:
+ * - The grid is split into CLUSTER_SIZE x CLUSTER_SIZE clusters
+ * - Every open run of cells along a cluster border becomes an entrance (two,
+ *   at its ends, once the run is LONG_ENTRANCE cells or more); the cells on
+ *   either side of it are abstract nodes linked by one step
+ * - Costs and cell paths between the nodes of each cluster are precomputed
+ * - A query links start and goal into their own clusters and searches only
+ *   the abstract graph, so its cost grows with the number of clusters the
+ *   path crosses rather than with its length in cells
+ * - The result is a corridor of nodes, refined into cells one segment at a
+ *   time by whoever walks it
+ * - Grid changes rebuild only the clusters they touch and their neighbors
+ *
+ * Paths are near-optimal: they pass through entrance cells rather than
+ * taking the best cell along each border. Queries and refinement are
+ * thread-safe; update() must not run concurrently with them.
+ */
+class PathHierarchy {
+public:
+    static constexpr int32_t CLUSTER_SIZE = 16;
+    static constexpr int32_t LONG_ENTRANCE = 6;
+
+    explicit PathHierarchy(const NavGrid& grid);
+
+    // Rebuild the clusters containing these cells and relink their neighbors
+    // (everything, the first time)
+    void update(const std::vector<int32_t>& changedCells);
+    void rebuild();
+    bool isBuilt() const { return !clusters.empty(); }
+
+    // Node corridor from start to goal: startCell, entrance cells..., goalCell.
+    // Returns false if the goal cannot be reached; expanded counts abstract
+    // nodes plus the cells searched to link start and goal into the graph.
+    bool findCorridor(int32_t startCell, int32_t goalCell, std::vector<int32_t>& corridor, uint32_t& expanded) const;
+
+    // Cells from fromCell to toCell (excluding fromCell) for one corridor segment
+    bool refineSegment(int32_t fromCell, int32_t toCell, std::vector<int32_t>& cells) const;
+
+    int32_t clusterOf(int32_t cell) const;
+    // Chebyshev distance between the clusters of two cells
+    int32_t clusterDistance(int32_t cellA, int32_t cellB) const;
+    int32_t getClusterCount() const { return clustersX * clustersZ; }
+    uint32_t getNodeCount() const;
+
+private:
+    static constexpr uint32_t NO_PATH = 0xFFFFFFFFu;
+
+    struct Cluster {
+        int32_t minX, minZ, maxX, maxZ;          // Cell bounds, max exclusive
+        std::vector<int32_t> nodes;              // Cell of each abstract node
+        std::vector<std::vector<int32_t>> exits; // Per node: linked node cells in neighboring clusters
+        std::vector<uint32_t> costs;             // nodes x nodes, NO_PATH if not connected inside the cluster
+        std::vector<std::vector<int32_t>> paths; // For i < j at i * n + j: cells from node i to j, excluding i
+    };
+
+    // Pairs of facing cells (this side, other side) per border: east of cluster c at 2c, south at 2c + 1
+    struct Border {
+        std::vector<int32_t> inner;
+        std::vector<int32_t> outer;
+    };
+
+    const NavGrid& grid;
+    int32_t clustersX;
+    int32_t clustersZ;
+    int32_t gridWidth; // Grid size when last rebuilt
+    int32_t gridHeight;
+    std::vector<Cluster> clusters;
+    std::vector<Border> borders;
+
+    int32_t nodeIndex(const Cluster& cluster, int32_t cell) const;
+    void buildBorder(int32_t cluster, bool south);
+    void linkCluster(int32_t cluster);
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "entity_handle.h"
+#include "path_service.h"
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * PathJobQueue - Path queries answered off the simulation tick
+ *
+ * Features:
+ * - Mobs request paths during their update instead of searching inline;
+ *   recording is thread-safe, and a newer request from the same mob replaces
+ *   its undelivered older one
+ * - Requests recorded during a tick are queued (in order key order) at the
+ *   start of the next one, and background workers run them through the
+ *   PathService while that tick's entity updates run
+ * - At the end of the tick the oldest finished results are committed, at
+ *   most getCommitsPerTick() of them; the rest wait for later ticks, so a
+ *   burst of requests cannot spike one frame
+ *
+ * Which results are committed on which tick depends only on the order of the
+ * requests, never on worker timing: the commit waits for (or runs itself) any
+ * of the capped batch that is not done yet. Workers only run between
+ * beginTick and endTick, so grid changes made between ticks never race with
+ * a search. Workers may finish jobs ticks ahead of their commit; if the
+ * PathService version changes in between (the grid changed), beginTick drops
+ * those results and the jobs are searched again, so every committed path was
+ * searched against the grid of the tick it is committed on.
+ */
+class PathJobQueue {
+public:
+    struct Result {
+        EntityHandle requester;
+        std::shared_ptr<const PathService::Path> path; // Null if start or goal lies off the grid
+    };
+
+    struct Stats {
+        uint64_t requested;
+        uint64_t replaced;    // Dropped for a newer request from the same mob
+        uint64_t committed;
+        uint64_t waits;       // Commits that had to wait for (or run) a search
+        uint64_t researched;  // Finished results dropped because the grid changed before their commit
+        size_t maxBacklog;    // Most requests queued at the start of a tick
+    };
+
+    static constexpr uint32_t DEFAULT_COMMITS_PER_TICK = 32;
+
+    // workerCount background threads, started on the first request; with
+    // none the searches run inside endTick
+    explicit PathJobQueue(PathService& service, size_t workerCount = 1);
+    ~PathJobQueue();
+
+    PathJobQueue(const PathJobQueue&) = delete;
+    PathJobQueue& operator=(const PathJobQueue&) = delete;
+
+    // Thread-safe. Requests recorded concurrently should pass the requesting
+    // entity's slot as the order key.
+    void request(EntityHandle requester, const glm::vec3& start, const glm::vec3& goal, uint32_t order = 0);
+
+    // Queue the requests recorded since the last tick and let the workers run
+    void beginTick();
+    // Stop the workers and append the results committed this tick, oldest first
+    void endTick(std::vector<Result>& committed);
+
+    void setCommitsPerTick(uint32_t count) { commitsPerTick = count > 0 ? count : 1; }
+    uint32_t getCommitsPerTick() const { return commitsPerTick; }
+    // Changing the count stops the current workers (not during a tick)
+    void setWorkerCount(size_t count);
+    size_t getWorkerCount() const { return workerCount; }
+
+    // Requests recorded or queued but not committed yet
+    size_t getPendingCount() const;
+
+    // Drop every request and result (not during a tick)
+    void clear();
+
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    struct Request {
+        EntityHandle requester;
+        glm::vec3 start;
+        glm::vec3 goal;
+        uint32_t order;
+    };
+
+    struct Job {
+        Request request;
+        std::shared_ptr<const PathService::Path> path;
+        bool taken;    // A thread has started (or skipped) the search
+        bool done;
+        bool replaced; // A newer request from the same mob was queued
+    };
+
+    PathService& service;
+    size_t workerCount;
+    uint32_t commitsPerTick;
+
+    mutable std::mutex mutex;
+    std::condition_variable workCondition;
+    std::condition_variable doneCondition;
+    std::vector<std::thread> workers;
+
+    std::vector<Request> recorded;                    // This tick's requests, not queued yet
+    std::deque<Job> jobs;                             // Queued in commit order; references stay valid
+    size_t nextJob;                                   // First job not yet taken
+    size_t busyWorkers;
+    std::unordered_map<uint32_t, Job*> latestJobs;    // Requester handle value -> its newest queued job
+    uint64_t searchedVersion;                         // PathService version the finished jobs were searched with
+    bool running;                                     // Between beginTick and endTick
+    bool stopping;
+    Stats stats;
+
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop();
+    // Take the next job and search it; called and returns with the lock held
+    void runNextJob(std::unique_lock<std::mutex>& lock);
+};
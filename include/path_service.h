@@ -0,0 +1,133 @@
+#pragma once
+
+#include "nav_grid.h"
+#include "path_hierarchy.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * PathService - A* over a NavGrid with a shared path cache
+ *
+ * Features:
+ * - 8-connected A* with octile costs; diagonal steps never cut a blocked corner
+ * - Cell paths are string-pulled into waypoints that can be walked in
+ *   straight lines
+ * - Results are cached by (start cell, goal cell) and handed out as shared,
+ *   immutable paths, so enemies leaving the same cell for the same PC reuse
+ *   one search
+ * - A path is marked stale for whoever still holds it when a cell it
+ *   crosses changes, and failed searches when any cell opens up. Any grid
+ *   change also empties the cache, so a cached path is always exactly what
+ *   a fresh search on the current grid returns (see getVersion)
+ * - Long queries (start and goal more than one cluster apart) search a
+ *   PathHierarchy instead and return a corridor of entrance cells that the
+ *   walker refines segment by segment as it goes. The hierarchy is built by
+ *   the first invalidate(), so an obstacle-free grid never pays for it.
+ * - Counters for queries, cache hits and expanded nodes
+ *
+ * findPath is thread-safe so mobs can query during a parallel update; the
+ * searches themselves run outside the cache lock. A path only depends on its
+ * key and the grid, so results do not depend on which thread asked first.
+ */
+class PathService {
+public:
+    struct Path {
+        int32_t startCell;
+        int32_t goalCell;
+        std::vector<glm::vec3> waypoints; // Flat search: after the start cell, ending on the goal cell's center
+        std::vector<int32_t> corridor;    // Hierarchical search: start cell, entrance cells, goal cell
+        bool stale;                       // A cell on the path changed since the search; query again
+
+        // Empty waypoints and corridor mean the goal is unreachable
+        bool found() const { return !waypoints.empty() || !corridor.empty(); }
+        // Pieces to walk one after another (see refineSegment)
+        size_t getSegmentCount() const {
+            return corridor.empty() ? (waypoints.empty() ? 0 : 1) : corridor.size() - 1;
+        }
+    };
+
+    struct Stats {
+        uint64_t queries;
+        uint64_t cacheHits;
+        uint64_t searches;      // Cache misses that ran a search
+        uint64_t hierarchicalSearches;
+        uint64_t expandedNodes; // Summed over all searches
+        uint64_t invalidated;   // Cached paths marked stale because the grid changed
+
+        double hitRate() const { return queries ? static_cast<double>(cacheHits) / queries : 0.0; }
+        double expandedPerQuery() const { return queries ? static_cast<double>(expandedNodes) / queries : 0.0; }
+        double expandedPerSearch() const { return searches ? static_cast<double>(expandedNodes) / searches : 0.0; }
+    };
+
+    static constexpr size_t DEFAULT_CACHE_CAPACITY = 4096;
+    // Searches give up (and report no path) after expanding this many cells
+    static constexpr uint32_t MAX_EXPANDED_NODES = 32768;
+
+    explicit PathService(const NavGrid& grid, size_t cacheCapacity = DEFAULT_CACHE_CAPACITY);
+
+    // Path from start's cell to goal's cell; null if either lies off the grid
+    std::shared_ptr<const Path> findPath(const glm::vec3& start, const glm::vec3& goal);
+
+    // Append the waypoints of one segment of a found path. Flat paths have a
+    // single segment holding all their waypoints.
+    void refineSegment(const Path& path, size_t segment, std::vector<glm::vec3>& waypoints) const;
+
+    // Use the hierarchy for long queries (on by default); clears the cache
+    void setHierarchical(bool enabled);
+    bool isHierarchical() const { return hierarchical; }
+    const PathHierarchy& getHierarchy() const { return hierarchy; }
+
+    // Rebuild affected clusters and drop cached paths affected by the given
+    // grid changes (not thread-safe with findPath)
+    void invalidate(const std::vector<int32_t>& changedCells);
+    void clearCache();
+    size_t getCacheSize() const;
+
+    // Bumped whenever results may change (grid changes, search mode); a
+    // search's result depends only on its cells and this version
+    uint64_t getVersion() const { return version; }
+
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    struct CacheEntry {
+        std::shared_ptr<Path> path;
+        std::vector<int32_t> cells; // Flat: grid cells the waypoints cross; hierarchical: clusters crossed. Sorted.
+        uint64_t lastUse;
+    };
+
+    const NavGrid& grid;
+    size_t cacheCapacity;
+    PathHierarchy hierarchy;
+    bool hierarchical;
+    uint64_t version;
+
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, CacheEntry> cache;
+    // Keys of the cached flat paths crossing each cell, and of hierarchical
+    // ones crossing each cluster; unreachable results are listed separately
+    std::unordered_map<int32_t, std::vector<uint64_t>> cellEntries;
+    std::unordered_map<int32_t, std::vector<uint64_t>> clusterEntries;
+    std::vector<uint64_t> unreachableEntries;
+    uint64_t useCounter;
+    Stats stats;
+
+    static uint64_t cacheKey(int32_t startCell, int32_t goalCell);
+
+    // A* and string pulling; returns the number of expanded cells
+    uint32_t search(int32_t startCell, int32_t goalCell, Path& path, std::vector<int32_t>& crossedCells) const;
+
+    // Waypoints for a cell path starting at cells[0]; appends the cells the waypoints cross if asked
+    void pullString(const std::vector<int32_t>& cells, std::vector<glm::vec3>& waypoints,
+                    std::vector<int32_t>* crossedCells) const;
+
+    // Cache bookkeeping, called with the mutex held
+    void insert(uint64_t key, CacheEntry entry);
+    void erase(uint64_t key);
+    void evictOldest();
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "entity_handle.h"
+#include "entity_storage.h"
+#include "nav_grid.h"
+#include "spatial_grid.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * ProjectileSystem - Pooled structure-of-arrays projectiles with batched hit tests
+ *
+ * Features:
+ * - Position, velocity, lifetime, radius, damage and owner live in flat
+ *   arrays; live projectiles are always the dense prefix [0, getCount())
+ * - Every array is sized to the capacity up front, so firing never
+ *   allocates; shots beyond capacity are dropped (and counted)
+ * - Integration is one branch-free pass per array that the compiler
+ *   vectorizes
+ * - Hits are found in a second pass: each projectile's step is swept
+ *   against the mobs the spatial hash grid buckets around it, skipping mobs
+ *   of its owner's kind, and walked cell by cell across the nav grid. The
+ *   first mob hit or blocked cell along the step ends the projectile, even
+ *   on the step its lifetime runs out.
+ *
+ * fire() is thread-safe so entity updates on worker threads can shoot;
+ * queued shots join at the next update in ascending order key, so the
+ * projectile order does not depend on thread timing.
+ */
+class ProjectileSystem {
+public:
+    struct Shot {
+        glm::vec3 position;
+        glm::vec3 velocity;
+        float lifetime; // seconds
+        float radius;
+        float damage;
+        EntityHandle owner;
+        EntityKind ownerKind; // Mobs of this kind are passed through
+    };
+
+    struct Hit {
+        uint32_t slot; // Storage slot of the mob that was hit
+        EntityHandle owner;
+        float damage;
+        glm::vec3 position; // Where the projectile touched the mob
+    };
+
+    struct Stats {
+        uint64_t fired;
+        uint64_t dropped; // Fired while the pool was full
+        uint64_t hits;
+        uint64_t blocked; // Stopped by a nav grid obstacle
+        uint64_t expired;
+    };
+
+    static constexpr size_t DEFAULT_CAPACITY = 8192;
+
+    explicit ProjectileSystem(size_t capacity = DEFAULT_CAPACITY);
+
+    // Queue a shot for the next update (thread-safe). Shots fired concurrently
+    // should pass the firing entity's slot as the order key.
+    void fire(const Shot& shot, uint32_t order = 0);
+
+    // Add queued shots, move everything by deltaTime, then retire projectiles
+    // that hit a mob of another kind in grid, crossed a blocked cell of navGrid
+    // or expired. grid must be built from storage's current positions. Hits are appended in projectile order.
+    void update(float deltaTime, const SpatialHashGrid& grid, const EntityStorage& storage, const NavGrid* navGrid,
+                std::vector<Hit>& hits);
+
+    // Resizes the pool; live projectiles beyond the new capacity are dropped
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const { return capacity; }
+    size_t getCount() const { return count; }
+
+    // True if shots were fired since the last update
+    bool hasQueuedShots() const;
+
+    // Drop every projectile and queued shot
+    void clear();
+
+    // Live projectile data, valid for [0, getCount())
+    const float* getPositionsX() const { return positionsX.data(); }
+    const float* getPositionsY() const { return positionsY.data(); }
+    const float* getPositionsZ() const { return positionsZ.data(); }
+    const float* getRadii() const { return radii.data(); }
+
+    Stats getStats() const { return stats; }
+    void resetStats() { stats = Stats{}; }
+
+private:
+    struct QueuedShot {
+        Shot shot;
+        uint32_t order;
+        uint32_t sequence; // Recording order, to keep one recorder's shots in order
+    };
+
+    size_t capacity;
+    size_t count;
+
+    std::vector<float> positionsX, positionsY, positionsZ;
+    std::vector<float> velocitiesX, velocitiesY, velocitiesZ;
+    std::vector<float> lifetimes;
+    std::vector<float> radii;
+    std::vector<float> damages;
+    std::vector<EntityHandle> owners;
+    std::vector<EntityKind> ownerKinds;
+
+    mutable std::mutex queueMutex;
+    std::vector<QueuedShot> queued;
+    std::vector<QueuedShot> adding; // Swapped with queued at each update
+    Stats stats;
+
+    void add(const Shot& shot);
+    void integrate(float deltaTime);
+    // Move the last live projectile into slot i
+    void removeAt(size_t i);
+};
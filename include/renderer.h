@@ -21,7 +21,8 @@ public:
 
     void renderGrid(float gridSize, int gridCount, const glm::vec3& color);
     void renderCircle(const glm::vec3& position, float radius, const glm::vec3& color, int segments = 32);
-    void renderEntities(const EntityManager& entityManager);
+    // alpha blends each entity between its previous and current simulation position
+    void renderEntities(const EntityManager& entityManager, float alpha = 1.0f);
 
     bool shouldClose() const;
     GLFWwindow* getWindow() const { return window; }
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// Summed (not yet averaged) separation push from a batch of neighbors
+struct SeparationResult {
+    glm::vec3 force{0.0f, 0.0f, 0.0f};
+    int count{0};
+};
+
+/**
+ * Separation force kernels
+ *
+ * Each kernel pushes a mob at position/radius away from every neighbor closer
+ * than (radius + neighborRadius) * 1.2, weighted by how deep the neighbor is
+ * inside that distance. Neighbors are passed as packed coordinate arrays with
+ * the mob itself already excluded.
+ *
+ * The SSE and AVX2 variants process 4 and 8 neighbors per step. They differ
+ * from the scalar version only in summation order.
+ */
+using SeparationKernel = SeparationResult (*)(const glm::vec3& position, float radius,
+                                              const float* xs, const float* ys, const float* zs,
+                                              const float* radii, size_t count);
+
+SeparationResult separationKernelScalar(const glm::vec3& position, float radius,
+                                        const float* xs, const float* ys, const float* zs,
+                                        const float* radii, size_t count);
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ACTIONRPG_HAS_X86_KERNELS 1
+
+SeparationResult separationKernelSSE(const glm::vec3& position, float radius,
+                                     const float* xs, const float* ys, const float* zs,
+                                     const float* radii, size_t count);
+
+SeparationResult separationKernelAVX2(const glm::vec3& position, float radius,
+                                      const float* xs, const float* ys, const float* zs,
+                                      const float* radii, size_t count);
+
+bool cpuSupportsSSE2();
+bool cpuSupportsAVX2();
+#endif
+
+// Fastest kernel the running CPU supports (detected once)
+SeparationKernel getSeparationKernel();
+const char* getSeparationKernelName();
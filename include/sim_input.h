@@ -0,0 +1,35 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * SimCommand - One player input, as applied to the simulation
+ *
+ * Everything that changes simulation state from outside goes through these,
+ * so a run can be recorded and replayed exactly. Randomness (e.g. where a
+ * spawned enemy appears) comes from the simulation's seeded RNG, not from
+ * the command.
+ */
+struct SimCommand {
+    enum class Type : uint8_t {
+        MoveTo,    // Move party member partyIndex to target
+        Stop,      // Stop party member partyIndex
+        SpawnEnemy // Spawn an enemy at a random position near the origin
+    };
+
+    Type type{Type::Stop};
+    uint8_t partyIndex{0};
+    glm::vec3 target{0.0f, 0.0f, 0.0f};
+
+    static SimCommand moveTo(size_t partyIndex, const glm::vec3& target) {
+        return {Type::MoveTo, static_cast<uint8_t>(partyIndex), target};
+    }
+    static SimCommand stop(size_t partyIndex) {
+        return {Type::Stop, static_cast<uint8_t>(partyIndex), glm::vec3(0.0f)};
+    }
+    static SimCommand spawnEnemy() {
+        return {Type::SpawnEnemy, 0, glm::vec3(0.0f)};
+    }
+};
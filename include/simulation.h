@@ -0,0 +1,73 @@
+#pragma once
+
+#include "entity.h"
+#include "sim_input.h"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+class InputRecorder;
+
+/**
+ * Simulation - Game state and per-tick logic with no window or GL dependency
+ *
+ * Owns the entity manager and the party. The game drives it from its frame
+ * loop; headless tools (benchmarks, replays) drive it directly.
+ *
+ * Player input arrives as SimCommands, queued and applied at the start of the
+ * next step. Together with the seeded RNG this makes a run reproducible from
+ * its seed and command log (see InputRecorder), given the same build.
+ */
+class Simulation {
+public:
+    // Fixed simulation step
+    static constexpr double TIMESTEP = 1.0 / 60.0; // seconds
+
+    // The default update mode is parallel; see EntityManager::setUpdateMode
+    explicit Simulation(UpdateMode mode = UpdateMode::Parallel, size_t workerThreads = 0, uint64_t seed = 0);
+
+    // Spawn the starting party of three PCs around the origin
+    void createParty();
+
+    std::shared_ptr<BasicShooterEnemy> spawnEnemy(const glm::vec3& position);
+
+    // Queue an input for the next step
+    void queueCommand(const SimCommand& command) { pendingCommands.push_back(command); }
+
+    // Every applied command is also logged to the recorder, if one is set
+    void setRecorder(InputRecorder* value) { recorder = value; }
+
+    void step(float deltaTime);
+
+    // World snapshot of the entity manager (see EntityManager::saveSnapshot).
+    // Loading rebuilds the party from the saved PCs; the tick count, RNG state
+    // and queued commands are not part of the snapshot.
+    bool saveSnapshot(const std::string& path) const;
+    bool loadSnapshot(const std::string& path);
+
+    EntityManager& getEntityManager() { return *entityManager; }
+    const EntityManager& getEntityManager() const { return *entityManager; }
+
+    const std::vector<std::shared_ptr<PlayerEntity>>& getParty() const { return party; }
+    uint64_t getTickCount() const { return tickCount; }
+    uint64_t getSeed() const { return seed; }
+
+private:
+    std::unique_ptr<EntityManager> entityManager;
+
+    // Party system
+    std::vector<std::shared_ptr<PlayerEntity>> party;
+
+    uint64_t tickCount;
+
+    // All simulation randomness comes from here
+    uint64_t seed;
+    std::mt19937_64 rng;
+
+    std::vector<SimCommand> pendingCommands;
+    InputRecorder* recorder;
+
+    void applyCommand(const SimCommand& command);
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "entity_storage.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * SpatialHashGrid - Uniform hash grid over the XZ plane for mob neighbor queries
+ *
+ * Features:
+ * - Rebuilt once per tick with a counting sort (no per-cell allocations)
+ * - Cells are hashed into a power-of-two bucket table, so the world is unbounded
+ * - Radius and box queries visit only the cells overlapping the query area;
+ *   k-nearest queries search outward ring by ring and rays walk the grid in
+ *   short stretches, both stopping as soon as nothing further can be closer
+ * - Buckets holding a mob that moved last tick are flagged as disturbed, so
+ *   sleeping mobs can check their neighborhood without a query
+ *
+ * Mobs are bucketed by their position at rebuild time; queries filter
+ * candidates by their current position in the storage the grid was built from.
+ * Results are storage slots, so callers read neighbor data straight from the
+ * storage arrays.
+ */
+class SpatialHashGrid {
+public:
+    // First contact of a swept circle; time is the fraction of the sweep in [0, 1]
+    struct SweepHit {
+        uint32_t slot;
+        float time;
+        glm::vec3 normal; // Unit XZ normal pointing from the hit mob toward the swept circle
+    };
+
+    // First mob along a ray; distance is measured over the XZ plane from the origin
+    struct RayHit {
+        uint32_t slot;
+        float distance;
+        glm::vec3 point;  // Where the ray enters the mob's collision circle (origin's y)
+        glm::vec3 normal; // Unit XZ normal pointing from the hit mob toward the ray
+    };
+
+    static constexpr uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    explicit SpatialHashGrid(float cellSize = 2.0f);
+
+    void rebuild(const EntityStorage& storage);
+    void clear();
+
+    // Collect the slot of every mob whose position lies within radius of position.
+    // The results vector is cleared first; its capacity is reused between calls.
+    void queryRadius(const glm::vec3& position, float radius, std::vector<uint32_t>& results) const;
+
+    // The filtered queries below only report mobs whose kind is in kinds. Like
+    // queryRadius they clear results first and never allocate once its capacity
+    // has grown to the largest result.
+
+    // Mobs of the given kinds within radius of position
+    void queryRadius(const glm::vec3& position, float radius, EntityKindMask kinds,
+                     std::vector<uint32_t>& results) const;
+
+    // Up to k mobs of the given kinds within maxDistance of position, nearest
+    // first (equal distances in slot order)
+    void queryKNearest(const glm::vec3& position, size_t k, float maxDistance, EntityKindMask kinds,
+                       std::vector<uint32_t>& results) const;
+
+    // Mobs of the given kinds whose position lies in the XZ box spanned by
+    // minCorner and maxCorner (y is ignored)
+    void queryAABB(const glm::vec3& minCorner, const glm::vec3& maxCorner, EntityKindMask kinds,
+                   std::vector<uint32_t>& results) const;
+
+    // First mob of the given kinds whose collision circle the ray from origin
+    // along direction (over the XZ plane) enters within maxDistance, ignoring
+    // ignoreSlot. A ray starting inside a mob hits it at distance 0.
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, EntityKindMask kinds,
+                 uint32_t ignoreSlot, RayHit& hit) const;
+
+    // Sweep a circle of radius from start to end over the XZ plane and report the
+    // earliest mob it touches, ignoring ignoreSlot. Mobs already overlapping at
+    // the start only count if the sweep moves deeper into them.
+    bool sweepCircle(const glm::vec3& start, const glm::vec3& end, float radius, uint32_t ignoreSlot,
+                     SweepHit& hit) const;
+
+    // Call fn(slot) for every mob bucketed in a cell overlapping the XZ box
+    // [minX, maxX] x [minZ, maxZ]. No distance test and no allocation, for
+    // batch callers that run their own narrow phase.
+    template <typename Fn>
+    void forEachInBox(float minX, float minZ, float maxX, float maxZ, Fn&& fn) const;
+
+    // True if a mob that moved last tick (stillTicks == 0) is in a cell within
+    // interaction range of position. Bucket collisions can give false positives.
+    bool isNeighborhoodDisturbed(const glm::vec3& position) const;
+
+    float getCellSize() const { return cellSize; }
+    float getMaxRadius() const { return maxRadius; }
+    size_t getMobCount() const { return cellEntries.size(); }
+
+private:
+    struct CellEntry {
+        uint32_t slot;
+        int32_t cellX;
+        int32_t cellZ;
+    };
+
+    const EntityStorage* source;
+
+    float cellSize;
+    float inverseCellSize;
+    float maxRadius; // Largest collision radius seen at rebuild
+    int32_t occupiedMinX, occupiedMinZ, occupiedMaxX, occupiedMaxZ; // Cell bounds of all mobs at rebuild
+
+    // Bucket b owns cellEntries[bucketStart[b] .. bucketStart[b + 1])
+    std::vector<uint32_t> bucketStart;
+    std::vector<CellEntry> cellEntries;
+    std::vector<CellEntry> scratchEntries;
+    std::vector<uint8_t> bucketDisturbed;
+    uint32_t bucketMask;
+    int32_t disturbRing; // Cells around a mob that a neighbor's movement can reach
+
+    int32_t cellCoord(float value) const {
+        // floor() without the libm call; this runs several times per query
+        float scaled = value * inverseCellSize;
+        int32_t cell = static_cast<int32_t>(scaled);
+        return scaled < static_cast<float>(cell) ? cell - 1 : cell;
+    }
+
+    uint32_t bucketIndex(int32_t cellX, int32_t cellZ) const {
+        // Large primes spread neighboring cells across the table
+        uint32_t h = static_cast<uint32_t>(cellX) * 73856093u ^ static_cast<uint32_t>(cellZ) * 19349663u;
+        return h & bucketMask;
+    }
+};
+
+template <typename Fn>
+void SpatialHashGrid::forEachInBox(float minX, float minZ, float maxX, float maxZ, Fn&& fn) const {
+    if (cellEntries.empty()) return;
+
+    const int32_t cellMinX = cellCoord(minX);
+    const int32_t cellMaxX = cellCoord(maxX);
+    const int32_t cellMinZ = cellCoord(minZ);
+    const int32_t cellMaxZ = cellCoord(maxZ);
+
+    int64_t cellSpan = static_cast<int64_t>(cellMaxX - cellMinX + 1) * static_cast<int64_t>(cellMaxZ - cellMinZ + 1);
+    if (cellSpan > static_cast<int64_t>(bucketMask) + 1) {
+        for (const CellEntry& entry : cellEntries) {
+            fn(entry.slot);
+        }
+        return;
+    }
+
+    for (int32_t cz = cellMinZ; cz <= cellMaxZ; ++cz) {
+        for (int32_t cx = cellMinX; cx <= cellMaxX; ++cx) {
+            uint32_t bucket = bucketIndex(cx, cz);
+            for (uint32_t i = bucketStart[bucket]; i < bucketStart[bucket + 1]; ++i) {
+                const CellEntry& entry = cellEntries[i];
+                if (entry.cellX == cx && entry.cellZ == cz) {
+                    fn(entry.slot);
+                }
+            }
+        }
+    }
+}
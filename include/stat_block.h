@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Mob stats that gear and buffs can modify
+enum class Stat : uint8_t {
+    MaxHealth,
+    MaxEnergy,
+    MovementSpeed,
+    AttackSpeed,
+    Count
+};
+
+constexpr size_t STAT_COUNT = static_cast<size_t>(Stat::Count);
+
+// How a modifier combines: (base + flat) * (1 + sum of increased) * product of (1 + more)
+enum class ModifierKind : uint8_t {
+    Flat,      // Added to the base value
+    Increased, // Fractions summed with every other Increased on the stat (0.1 = +10%)
+    More       // Separate multiplier of (1 + value)
+};
+
+struct StatModifier {
+    uint32_t source; // Whoever applied it (item, buff, aura); removed together
+    float value;
+    Stat stat;
+    ModifierKind kind;
+};
+
+/**
+ * StatBlock - Base stats, modifier stack and precomputed derived values
+ *
+ * Features:
+ * - Derived values live in one flat array and get() is a plain load, so hot
+ *   loops pay nothing for modifiers
+ * - Changing a base value or the modifier stack recomputes only the stats
+ *   it touched, right away; nothing is aggregated on read
+ * - Modifiers are kept in one compact unsorted vector (12 bytes each) and
+ *   are removed by source, e.g. everything an unequipped item granted
+ * - getVersion() changes whenever any derived value may have changed, so
+ *   values computed from stats (avoidance radius, fire interval) can be
+ *   cached and refreshed with one comparison
+ *
+ * Derived values are clamped at zero.
+ */
+class StatBlock {
+public:
+    StatBlock();
+
+    float get(Stat stat) const { return derived[static_cast<size_t>(stat)]; }
+    const float* getDerived() const { return derived; }
+
+    float getBase(Stat stat) const { return base[static_cast<size_t>(stat)]; }
+    void setBase(Stat stat, float value);
+
+    void addModifier(const StatModifier& modifier);
+
+    // Remove every modifier from source; returns how many there were
+    size_t removeModifiers(uint32_t source);
+    void clearModifiers();
+
+    const std::vector<StatModifier>& getModifiers() const { return modifiers; }
+    uint32_t getVersion() const { return version; }
+
+private:
+    float base[STAT_COUNT];
+    float derived[STAT_COUNT];
+    std::vector<StatModifier> modifiers;
+    uint32_t version;
+
+    // Recompute the stats whose bits are set in statMask
+    void recompute(uint32_t statMask);
+};
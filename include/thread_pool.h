@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * ThreadPool - Fixed set of worker threads for fork/join loops
+ *
+ * parallelFor splits [0, count) into chunks that workers (and the calling
+ * thread) claim from a shared atomic counter, and returns once every chunk
+ * has run. Only one parallelFor may be in flight at a time.
+ */
+class ThreadPool {
+public:
+    // workerCount extra threads are started; the caller is always one more
+    explicit ThreadPool(size_t workerCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& fn);
+
+    // Number of threads that run work, including the caller
+    size_t getThreadCount() const { return workers.size() + 1; }
+
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    const std::function<void(size_t, size_t)>* job;
+    size_t jobCount;
+    size_t jobChunkSize;
+    std::atomic<size_t> nextChunk;
+    size_t busyWorkers;
+    uint64_t jobGeneration;
+    bool stopping;
+
+    void workerLoop();
+    void runChunks();
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "entity_handle.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Generational reference to a scheduled timer; the default value is null
+struct TimerHandle {
+    uint32_t index{0};
+    uint32_t generation{0}; // Starts at 1 for live timers
+
+    bool isValid() const { return generation != 0; }
+
+    bool operator==(const TimerHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const TimerHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * TimerWheel - Hierarchical timing wheel for tick-based expirations
+ *
+ * Features:
+ * - schedule() and cancel() are O(1): a timer is linked into one slot of
+ *   one of LEVELS wheels of SLOTS slots, chosen by how far away it is due
+ * - advance() only touches the slot for the new tick, plus one slot of a
+ *   coarser wheel every SLOTS ticks, whose timers move down a level
+ * - Timers live in one pooled node array threaded with index links, so
+ *   scheduling allocates nothing once the pool has grown (see reserve)
+ * - Periodic timers re-arm themselves after firing, under the same handle,
+ *   until cancelled
+ *
+ * Timers due on the same tick fire in the order they were scheduled (a
+ * periodic timer counts as scheduled when it last fired). Delays are whole
+ * ticks; the wheels cover any 32-bit delay. Handles of fired one-shot and
+ * cancelled timers resolve to nothing. Not thread-safe.
+ */
+class TimerWheel {
+public:
+    static constexpr uint32_t SLOT_BITS = 6;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t LEVELS = 6; // SLOT_BITS * LEVELS >= 32 covers every delay
+
+    // What a timer carries back when it fires; tag and data mean whatever the scheduler decides
+    struct Expiry {
+        TimerHandle timer;
+        EntityHandle entity;
+        uint32_t tag;
+        uint32_t data;
+        uint64_t tick; // Tick it was due on
+    };
+
+    TimerWheel();
+
+    // Fire delay ticks from now (a delay of 0 fires on the next advance). With
+    // period > 0 the timer fires again every period ticks until cancelled.
+    TimerHandle schedule(uint32_t delay, EntityHandle entity, uint32_t tag, uint32_t data = 0, uint32_t period = 0);
+
+    // False if the timer already fired (one-shot) or was cancelled
+    bool cancel(TimerHandle timer);
+
+    bool isPending(TimerHandle timer) const;
+
+    // Ticks until the timer fires; 0 if it is not pending
+    uint64_t getRemaining(TimerHandle timer) const;
+
+    // Move time forward by ticks, appending every timer that comes due to
+    // expired (in tick order)
+    void advance(uint32_t ticks, std::vector<Expiry>& expired);
+
+    uint64_t getNow() const { return now; }
+    size_t size() const { return pendingCount; }
+
+    // Pre-size the node pool for this many concurrent timers
+    void reserve(size_t timerCount);
+
+    // Drop every timer (outstanding handles become stale) and restart at tick 0
+    void clear();
+
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    static constexpr uint16_t NO_BUCKET = 0xFFFF;
+
+    struct Node {
+        uint64_t due;
+        uint32_t period;
+        uint32_t next;       // Next in the bucket, or next free node
+        uint32_t prev;
+        uint32_t generation; // Bumped whenever the node is released
+        uint16_t bucket;     // level * SLOTS + slot, NO_BUCKET while not scheduled
+        EntityHandle entity;
+        uint32_t tag;
+        uint32_t data;
+    };
+
+    std::vector<Node> nodes;
+    uint32_t freeHead;
+    uint32_t heads[LEVELS * SLOTS];
+    uint32_t tails[LEVELS * SLOTS];
+    uint64_t now;
+    size_t pendingCount;
+
+    const Node* find(TimerHandle timer) const;
+
+    // Link a node into the bucket for its due tick (appended, so FIFO per bucket)
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+
+    // Re-link every timer of a coarser bucket that now belongs lower down
+    void cascade(uint32_t level);
+};
@@ -0,0 +1,156 @@
+#include "ai_scheduler.h"
+#include "entity.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+uint32_t tierInterval(AITier tier) {
+    switch (tier) {
+        case AITier::Near: return 1;
+        case AITier::Mid: return AIScheduler::MID_INTERVAL;
+        case AITier::Far: return AIScheduler::FAR_INTERVAL;
+    }
+    return 1;
+}
+
+} // namespace
+
+AIScheduler::AIScheduler()
+    : nearDistanceSq(20.0f * 20.0f)
+    , midDistanceSq(40.0f * 40.0f)
+    , budgetMicroseconds(0.0)
+    , tick(0)
+    , thinkNanoseconds(0)
+    , lastThinkCount(0)
+    , averageThinkNanoseconds(0.0)
+    , stats{}
+{
+}
+
+void AIScheduler::setTierDistances(float nearDistance, float midDistance) {
+    nearDistanceSq = nearDistance * nearDistance;
+    midDistanceSq = midDistance * midDistance;
+}
+
+void AIScheduler::reset() {
+    tick = 0;
+    agents.clear();
+    thinkFlags.clear();
+    candidates.clear();
+    thinkNanoseconds.store(0, std::memory_order_relaxed);
+    lastThinkCount = 0;
+    averageThinkNanoseconds = 0.0;
+    stats = Stats{};
+}
+
+AITier AIScheduler::classify(const glm::vec3& position, bool idle, const FlowField& flowField,
+                             const std::vector<FlowField::Goal>& party) const {
+    // The flow field has the path distance ready; off the field, check the party directly
+    float distanceSq;
+    FlowField::Sample flow;
+    if (flowField.sample(position, flow)) {
+        distanceSq = flow.distance * flow.distance;
+    } else {
+        distanceSq = std::numeric_limits<float>::max();
+        for (const FlowField::Goal& pc : party) {
+            glm::vec3 offset = pc.position - position;
+            distanceSq = std::min(distanceSq, glm::dot(offset, offset));
+        }
+    }
+
+    AITier tier = distanceSq < nearDistanceSq ? AITier::Near
+                : distanceSq < midDistanceSq ? AITier::Mid
+                : AITier::Far;
+
+    if (idle && tier != AITier::Far) {
+        tier = static_cast<AITier>(static_cast<uint8_t>(tier) + 1);
+    }
+    return tier;
+}
+
+void AIScheduler::plan(const std::vector<std::shared_ptr<Entity>>& entities, const EntityStorage& storage,
+                       const FlowField& flowField, const std::vector<FlowField::Goal>& party) {
+    tick++;
+
+    // Fold last tick's measured think time into the per-think estimate
+    uint64_t measured = thinkNanoseconds.exchange(0, std::memory_order_relaxed);
+    stats = Stats{};
+    stats.thinkMicroseconds = measured / 1000.0;
+    if (lastThinkCount > 0 && measured > 0) {
+        double perThink = static_cast<double>(measured) / lastThinkCount;
+        averageThinkNanoseconds = averageThinkNanoseconds > 0.0
+            ? averageThinkNanoseconds * 0.8 + perThink * 0.2
+            : perThink;
+    }
+
+    const uint32_t count = storage.size();
+    thinkFlags.assign(count, 0);
+    candidates.clear();
+    uint32_t thinkCount = 0;
+
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        if (storage.kinds[slot] != EntityKind::Enemy || !storage.active[slot]) continue;
+
+        // Idle: barely moved during the last tick
+        glm::vec3 lastStep = storage.positions[slot] - storage.previousPositions[slot];
+        bool idle = glm::dot(lastStep, lastStep) < IDLE_STEP * IDLE_STEP;
+
+        AITier tier = classify(storage.positions[slot], idle, flowField, party);
+        uint32_t interval = tierInterval(tier);
+        stats.agents[static_cast<size_t>(tier)]++;
+
+        EntityHandle handle = entities[slot]->getHandle();
+        uint32_t index = handle.index();
+        if (index >= agents.size()) {
+            agents.resize(index + 1, AgentState{0, 0});
+        }
+
+        AgentState& agent = agents[index];
+        if (agent.generation != handle.generation()) {
+            // New agent: decide right away, then fall into a staggered turn
+            agent.generation = handle.generation();
+            agent.lastThinkTick = tick - (index % interval);
+            thinkFlags[slot] = 1;
+            stats.updated[static_cast<size_t>(tier)]++;
+            thinkCount++;
+            continue;
+        }
+
+        uint64_t elapsed = tick - agent.lastThinkTick;
+        if (tier == AITier::Near) {
+            agent.lastThinkTick = tick;
+            thinkFlags[slot] = 1;
+            stats.updated[static_cast<size_t>(tier)]++;
+            thinkCount++;
+        } else if (elapsed >= interval) {
+            candidates.push_back({slot, index, elapsed - interval, tier});
+        }
+    }
+
+    // Hand what is left of the budget to the most overdue sliced agents
+    size_t allowed = candidates.size();
+    if (budgetMicroseconds > 0.0 && averageThinkNanoseconds > 0.0) {
+        double budgetThinks = budgetMicroseconds * 1000.0 / averageThinkNanoseconds;
+        double remaining = budgetThinks - static_cast<double>(thinkCount);
+        allowed = std::min(allowed, std::max<size_t>(MIN_SLICED_THINKS, remaining > 0.0 ? static_cast<size_t>(remaining) : 0));
+    }
+
+    if (allowed < candidates.size()) {
+        std::nth_element(candidates.begin(), candidates.begin() + allowed, candidates.end(),
+                         [](const Candidate& a, const Candidate& b) {
+                             return a.overdue != b.overdue ? a.overdue > b.overdue : a.handleIndex < b.handleIndex;
+                         });
+        stats.deferred = static_cast<uint32_t>(candidates.size() - allowed);
+    }
+
+    for (size_t i = 0; i < allowed; ++i) {
+        const Candidate& candidate = candidates[i];
+        agents[candidate.handleIndex].lastThinkTick = tick;
+        thinkFlags[candidate.slot] = 1;
+        stats.updated[static_cast<size_t>(candidate.tier)]++;
+        thinkCount++;
+    }
+
+    lastThinkCount = thinkCount;
+}
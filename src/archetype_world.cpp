@@ -0,0 +1,215 @@
+#include "archetype_world.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+namespace {
+
+struct ComponentType {
+    size_t size;
+    size_t alignment;
+};
+
+// Registered component types, indexed by id; ids are handed out once and the
+// table only grows, so reads after registration need no lock
+std::mutex registryMutex;
+ComponentType registry[ArchetypeWorld::MAX_COMPONENT_TYPES];
+uint32_t registeredCount = 0;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+uint32_t ArchetypeWorld::registerComponent(size_t size, size_t alignment) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    // Masks are 64-bit, so there is no way to carry on with another type
+    if (registeredCount == MAX_COMPONENT_TYPES) {
+        std::cerr << "ArchetypeWorld: more than " << MAX_COMPONENT_TYPES << " component types" << std::endl;
+        std::abort();
+    }
+    uint32_t id = registeredCount++;
+    registry[id] = {size, alignment};
+    return id;
+}
+
+size_t ArchetypeWorld::componentSize(uint32_t id) {
+    return registry[id].size;
+}
+
+size_t ArchetypeWorld::componentAlignment(uint32_t id) {
+    return registry[id].alignment;
+}
+
+uint32_t ArchetypeWorld::findOrCreateArchetype(ComponentMask mask) {
+    for (uint32_t i = 0; i < archetypes.size(); ++i) {
+        if (archetypes[i]->mask == mask) return i;
+    }
+
+    auto archetype = std::make_unique<Archetype>();
+    archetype->mask = mask;
+    archetype->entityCount = 0;
+    for (uint32_t id = 0; id < MAX_COMPONENT_TYPES; ++id) {
+        if (mask & (ComponentMask(1) << id)) {
+            archetype->components.push_back(id);
+        }
+        archetype->columnOffsets[id] = 0;
+    }
+
+    // Fit as many rows as the chunk holds once every array is aligned: start
+    // from the unpadded estimate and back off until the padded layout fits
+    size_t rowBytes = sizeof(EntityHandle);
+    for (uint32_t id : archetype->components) {
+        rowBytes += componentSize(id);
+    }
+    size_t capacity = CHUNK_BYTES / rowBytes;
+    for (;; --capacity) {
+        size_t offset = sizeof(EntityHandle) * capacity;
+        for (uint32_t id : archetype->components) {
+            offset = alignUp(offset, componentAlignment(id));
+            archetype->columnOffsets[id] = static_cast<uint32_t>(offset);
+            offset += componentSize(id) * capacity;
+        }
+        if (offset <= CHUNK_BYTES) break;
+    }
+    if (capacity == 0) {
+        std::cerr << "ArchetypeWorld: a row of " << rowBytes << " bytes does not fit a " << CHUNK_BYTES
+                  << " byte chunk" << std::endl;
+        std::abort();
+    }
+    archetype->capacity = static_cast<uint32_t>(capacity);
+
+    archetypes.push_back(std::move(archetype));
+    return static_cast<uint32_t>(archetypes.size() - 1);
+}
+
+uint32_t ArchetypeWorld::appendRow(Archetype& archetype, EntityHandle handle) {
+    if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity) {
+        Chunk chunk;
+        chunk.data.reset(new std::max_align_t[CHUNK_BYTES / sizeof(std::max_align_t)]);
+        chunk.count = 0;
+        archetype.chunks.push_back(std::move(chunk));
+    }
+
+    Chunk& chunk = archetype.chunks.back();
+    reinterpret_cast<EntityHandle*>(chunk.bytes())[chunk.count++] = handle;
+    return static_cast<uint32_t>(archetype.entityCount++);
+}
+
+EntityHandle ArchetypeWorld::allocate(uint32_t archetypeIndex) {
+    uint32_t index;
+    if (freeHandleHead != NO_FREE_HANDLE) {
+        index = freeHandleHead;
+        freeHandleHead = locations[index].archetype;
+    } else if (locations.size() <= EntityHandle::INDEX_MASK) {
+        index = static_cast<uint32_t>(locations.size());
+        locations.push_back({0, 0, 1});
+    } else {
+        // A wider index would wrap in the handle and alias a live entity
+        std::cerr << "ArchetypeWorld: more than " << EntityHandle::INDEX_MASK + 1 << " live entities" << std::endl;
+        std::abort();
+    }
+
+    EntityHandle handle(index, locations[index].generation);
+    locations[index].archetype = archetypeIndex;
+    locations[index].row = appendRow(*archetypes[archetypeIndex], handle);
+    liveCount++;
+    return handle;
+}
+
+uint8_t* ArchetypeWorld::componentAt(const Archetype& archetype, uint32_t row, uint32_t id) const {
+    const Chunk& chunk = archetype.chunks[row / archetype.capacity];
+    return chunk.bytes() + archetype.columnOffsets[id] + componentSize(id) * (row % archetype.capacity);
+}
+
+void ArchetypeWorld::removeRow(uint32_t archetypeIndex, uint32_t row) {
+    Archetype& archetype = *archetypes[archetypeIndex];
+    const uint32_t last = static_cast<uint32_t>(--archetype.entityCount);
+
+    if (row != last) {
+        // Move the last row into the hole and repoint its entity
+        Chunk& toChunk = archetype.chunks[row / archetype.capacity];
+        const Chunk& fromChunk = archetype.chunks[last / archetype.capacity];
+        const uint32_t toIndex = row % archetype.capacity;
+        const uint32_t fromIndex = last % archetype.capacity;
+
+        EntityHandle moved = reinterpret_cast<const EntityHandle*>(fromChunk.bytes())[fromIndex];
+        reinterpret_cast<EntityHandle*>(toChunk.bytes())[toIndex] = moved;
+        for (uint32_t id : archetype.components) {
+            std::memcpy(componentAt(archetype, row, id), componentAt(archetype, last, id), componentSize(id));
+        }
+        locations[moved.index()].row = row;
+    }
+
+    // Chunks are only ever empty at the end; let the empty one go
+    Chunk& tail = archetype.chunks.back();
+    if (--tail.count == 0) {
+        archetype.chunks.pop_back();
+    }
+}
+
+bool ArchetypeWorld::tryGetLocation(EntityHandle handle, const Location*& location) const {
+    if (!handle.isValid() || handle.index() >= locations.size()) return false;
+
+    const Location& entry = locations[handle.index()];
+    if (entry.generation != handle.generation()) return false;
+
+    location = &entry;
+    return true;
+}
+
+bool ArchetypeWorld::isAlive(EntityHandle handle) const {
+    const Location* location;
+    return tryGetLocation(handle, location);
+}
+
+void ArchetypeWorld::destroy(EntityHandle handle) {
+    const Location* location;
+    if (!tryGetLocation(handle, location)) return;
+
+    removeRow(location->archetype, location->row);
+    liveCount--;
+
+    // Bump the generation so outstanding copies of this handle go stale
+    Location& entry = locations[handle.index()];
+    entry.generation = (entry.generation + 1) & EntityHandle::GENERATION_MASK;
+    if (entry.generation == 0) {
+        entry.generation = 1;
+    }
+    entry.archetype = freeHandleHead;
+    freeHandleHead = handle.index();
+}
+
+void ArchetypeWorld::changeArchetype(EntityHandle handle, ComponentMask newMask) {
+    const uint32_t fromIndex = locations[handle.index()].archetype;
+    const uint32_t fromRow = locations[handle.index()].row;
+    const uint32_t toIndex = findOrCreateArchetype(newMask);
+    const Archetype& from = *archetypes[fromIndex];
+    Archetype& to = *archetypes[toIndex];
+
+    // The entity keeps its handle; only its row moves
+    const uint32_t toRow = appendRow(to, handle);
+
+    // Components in both sets come along; new ones start zeroed until add() writes them
+    for (uint32_t id : to.components) {
+        if (from.mask & (ComponentMask(1) << id)) {
+            std::memcpy(componentAt(to, toRow, id), componentAt(from, fromRow, id), componentSize(id));
+        } else {
+            std::memset(componentAt(to, toRow, id), 0, componentSize(id));
+        }
+    }
+
+    removeRow(fromIndex, fromRow);
+    locations[handle.index()].archetype = toIndex;
+    locations[handle.index()].row = toRow;
+}
+
+void ArchetypeWorld::clear() {
+    archetypes.clear();
+    locations.clear();
+    freeHandleHead = NO_FREE_HANDLE;
+    liveCount = 0;
+    queryChunks.clear();
+}
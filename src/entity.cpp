@@ -1,147 +1,131 @@
 #include "entity.h"
+#include "mob_collision.h"
+#include "orca_solver.h"
 #include <algorithm>
+#include <chrono>
+#include <iostream>
 #include <limits>
 #include <glm/gtc/constants.hpp>
 #include <glm/common.hpp>
 
 void MobEntity::update(float deltaTime) {
-    if (isMoving) {
+    // Settled with nothing moving nearby: separation would not move us either
+    if (isSleeping() && !isMoving()) return;
+
+    const glm::vec3 start = getPosition();
+    glm::vec3 position = start;
+
+    if (isMoving()) {
+        glm::vec3 targetPosition = getTargetPosition();
         glm::vec3 direction = targetPosition - position;
         float distance = glm::length(direction);
 
         if (distance > 0.1f) {
             direction = glm::normalize(direction);
-            float moveDistance = movementSpeed * deltaTime;
+            float moveDistance = getMovementSpeed() * deltaTime;
 
             glm::vec3 desiredPosition;
             if (moveDistance >= distance) {
                 desiredPosition = targetPosition;
-                isMoving = false;
+                setMoving(false);
             } else {
                 desiredPosition = position + direction * moveDistance;
             }
 
             // Apply collision resolution with sliding
-            glm::vec3 finalPosition = resolveCollisions(desiredPosition, deltaTime);
-            position = finalPosition;
+            if (entityManager && entityManager->getCollisionMode() == CollisionMode::Continuous) {
+                desiredPosition = sweepToFirstContact(position, desiredPosition);
+            }
+            position = resolveCollisions(desiredPosition, deltaTime);
 
             // Check if we've reached close enough to target after collision resolution
             if (glm::length(targetPosition - position) < 0.1f) {
                 position = targetPosition;
-                isMoving = false;
+                setMoving(false);
             }
         } else {
             position = targetPosition;
-            isMoving = false;
+            setMoving(false);
         }
     }
 
     // Apply continuous separation forces even when not explicitly moving
-    applySeparationForces(deltaTime);
+    position = applySeparationForces(position, deltaTime);
+
+    // Blocked nav grid cells are solid
+    if (entityManager) {
+        position = entityManager->getNavGrid().slideToWalkable(start, position);
+    }
+    setPosition(position);
 }
 
 void MobEntity::moveTo(const glm::vec3& target) {
-    targetPosition = target;
-    isMoving = true;
+    (storage ? storage->targetPositions[slot] : detached.targetPosition) = target;
+    setMoving(true);
+    wake();
 }
 
-void MobEntity::stop() {
-    isMoving = false;
+void MobEntity::wake() {
+    if (storage) {
+        storage->sleeping[slot] = 0;
+        storage->stillTicks[slot] = 0;
+    }
 }
 
-glm::vec3 MobEntity::resolveCollisions(const glm::vec3& desiredPosition, float deltaTime) {
-    if (!entityManager) return desiredPosition;
-
-    glm::vec3 movement = desiredPosition - position;
-    glm::vec3 finalPosition = desiredPosition;
-
-    // Collect all overlapping entities
-    std::vector<std::pair<MobEntity*, float>> collisions;
-    const auto& entities = entityManager->getEntities();
-
-    for (const auto& other : entities) {
-        if (other.get() == this) continue;
-
-        auto otherMob = std::dynamic_pointer_cast<MobEntity>(other);
-        if (!otherMob || !otherMob->active) continue;
-
-        glm::vec3 toOther = otherMob->position - desiredPosition;
-        float distance = glm::length(toOther);
-        float minDistance = radius + otherMob->radius;
-
-        if (distance < minDistance) {
-            collisions.push_back({otherMob.get(), distance});
-        }
-    }
+void MobEntity::stop() {
+    setMoving(false);
+}
 
-    // Process collisions with sliding
-    for (const auto& [otherMob, distance] : collisions) {
-        glm::vec3 toOther = otherMob->position - finalPosition;
-        float currentDist = glm::length(toOther);
-        float minDistance = radius + otherMob->radius;
-
-        if (currentDist < minDistance && currentDist > 0.001f) {
-            // Calculate penetration depth
-            float penetration = minDistance - currentDist;
-            glm::vec3 separationDir = -glm::normalize(toOther);
-
-            // Instead of stopping, slide along the collision surface
-            // Project movement onto the plane tangent to collision
-            glm::vec3 collisionNormal = -toOther / currentDist;
-            glm::vec3 slideDirection = movement - collisionNormal * glm::dot(movement, collisionNormal);
-
-            // Apply sliding with some friction
-            float slideFactor = 0.7f; // Friction coefficient (0 = full stop, 1 = perfect slide)
-            finalPosition = position + slideDirection * slideFactor;
-
-            // Ensure we're not still penetrating after slide
-            glm::vec3 afterSlideToOther = otherMob->position - finalPosition;
-            float afterSlideDist = glm::length(afterSlideToOther);
-            if (afterSlideDist < minDistance && afterSlideDist > 0.001f) {
-                // Push out to minimum distance
-                finalPosition = otherMob->position - glm::normalize(afterSlideToOther) * minDistance;
-            }
-        }
+void MobEntity::setMoving(bool value) {
+    if (storage) {
+        storage->moving[slot] = value ? 1 : 0;
+    } else {
+        detached.moving = value;
     }
+}
 
+glm::vec3 MobEntity::resolveCollisions(const glm::vec3& desiredPosition, float deltaTime) {
+    if (!entityManager || !storage) return desiredPosition;
+
+    // Every contact found this step, for combat and other listeners
+    thread_local std::vector<MobContact> contacts;
+    contacts.clear();
+    const bool publish = entityManager->getEvents().isWanted<CollisionEvent>();
+    glm::vec3 finalPosition = resolveMobCollisions(entityManager->getSpatialGrid(), storage->positions, storage->radii,
+                                                   slot, desiredPosition, publish ? &contacts : nullptr);
+    publishCollisions(contacts);
     return finalPosition;
 }
 
-void MobEntity::applySeparationForces(float deltaTime) {
-    if (!entityManager) return;
+glm::vec3 MobEntity::sweepToFirstContact(const glm::vec3& start, const glm::vec3& desiredPosition) {
+    if (!entityManager || !storage) return desiredPosition;
 
-    glm::vec3 separationForce(0.0f);
-    int nearbyCount = 0;
+    thread_local std::vector<MobContact> contacts;
+    contacts.clear();
+    const bool publish = entityManager->getEvents().isWanted<CollisionEvent>();
+    glm::vec3 position = sweepMobToFirstContact(entityManager->getSpatialGrid(), storage->radii, slot, start,
+                                                desiredPosition, publish ? &contacts : nullptr);
+    publishCollisions(contacts);
+    return position;
+}
 
+void MobEntity::publishCollisions(const std::vector<MobContact>& contacts) {
     const auto& entities = entityManager->getEntities();
-    for (const auto& other : entities) {
-        if (other.get() == this) continue;
-
-        auto otherMob = std::dynamic_pointer_cast<MobEntity>(other);
-        if (!otherMob || !otherMob->active) continue;
-
-        glm::vec3 toOther = position - otherMob->position;
-        float distance = glm::length(toOther);
-        float preferredDistance = (radius + otherMob->radius) * 1.2f; // Add some buffer
-
-        // Apply gentle separation force when entities are too close
-        if (distance < preferredDistance && distance > 0.001f) {
-            float strength = (preferredDistance - distance) / preferredDistance;
-            separationForce += (toOther / distance) * strength;
-            nearbyCount++;
-        }
+    for (const MobContact& contact : contacts) {
+        entityManager->getEvents().publish(
+            CollisionEvent{handle, entities[contact.other]->getHandle(), contact.position}, slot);
     }
+}
 
-    // Apply the averaged separation force
-    if (nearbyCount > 0) {
-        separationForce /= static_cast<float>(nearbyCount);
-        float separationSpeed = 2.0f; // Gentle push speed
-        position += separationForce * separationSpeed * deltaTime;
-    }
+glm::vec3 MobEntity::applySeparationForces(const glm::vec3& position, float deltaTime) {
+    if (!entityManager || !storage) return position;
+
+    return applyMobSeparation(entityManager->getSpatialGrid(), storage->positions, storage->radii, slot, position,
+                              deltaTime);
 }
 
 glm::vec3 MobEntity::calculateSteeringForce(const glm::vec3& targetPos, float avoidanceRadius) {
-    glm::vec3 desiredDirection = targetPos - position;
+    glm::vec3 desiredDirection = targetPos - getPosition();
     float distToTarget = glm::length(desiredDirection);
 
     if (distToTarget < 0.01f) {
@@ -149,7 +133,17 @@ glm::vec3 MobEntity::calculateSteeringForce(const glm::vec3& targetPos, float av
     }
 
     // Attraction toward target
-    glm::vec3 seekForce = glm::normalize(desiredDirection);
+    return steerAlong(glm::normalize(desiredDirection), avoidanceRadius);
+}
+
+glm::vec3 MobEntity::steerAlong(const glm::vec3& seekForce, float avoidanceRadius) {
+    if (entityManager && storage && entityManager->getSteeringMode() == SteeringMode::Reciprocal) {
+        return steerReciprocal(seekForce);
+    }
+
+    const glm::vec3 position = getPosition();
+    const float radius = getRadius();
+    const float movementSpeed = getMovementSpeed();
 
     // Predictive avoidance - look ahead to where we'll be
     glm::vec3 futurePos = position + seekForce * movementSpeed * 0.5f; // Look 0.5 seconds ahead
@@ -158,23 +152,29 @@ glm::vec3 MobEntity::calculateSteeringForce(const glm::vec3& targetPos, float av
     glm::vec3 avoidanceForce(0.0f);
     bool needsAvoidance = false;
 
-    if (entityManager) {
-        const auto& entities = entityManager->getEntities();
-        for (const auto& other : entities) {
-            if (other.get() == this) continue;
+    if (entityManager && storage) {
+        const std::vector<glm::vec3>& positions = storage->positions;
+        const std::vector<float>& radii = storage->radii;
+
+        // Cover both the avoidance radius and the look-ahead probe around futurePos
+        thread_local std::vector<uint32_t> neighbors;
+        float probeReach = movementSpeed * 0.5f + radius + entityManager->getMaxMobRadius() + 0.3f;
+        entityManager->queryRadius(position, glm::max(avoidanceRadius, probeReach), neighbors);
 
-            auto otherMob = std::dynamic_pointer_cast<MobEntity>(other);
-            if (!otherMob || !otherMob->active) continue;
+        for (uint32_t other : neighbors) {
+            if (other == slot) continue;
+
+            const glm::vec3& otherPosition = positions[other];
 
             // Check both current and future positions
-            glm::vec3 toOtherFuture = otherMob->position - futurePos;
+            glm::vec3 toOtherFuture = otherPosition - futurePos;
             float futureDist = glm::length(toOtherFuture);
 
-            glm::vec3 toOtherCurrent = otherMob->position - position;
+            glm::vec3 toOtherCurrent = otherPosition - position;
             float currentDist = glm::length(toOtherCurrent);
 
             // Determine if we need to avoid this obstacle
-            float effectiveRadius = radius + otherMob->radius + 0.3f; // Add buffer
+            float effectiveRadius = radius + radii[other] + 0.3f; // Add buffer
 
             if (futureDist < effectiveRadius || currentDist < avoidanceRadius) {
                 needsAvoidance = true;
@@ -197,8 +197,8 @@ glm::vec3 MobEntity::calculateSteeringForce(const glm::vec3& targetPos, float av
                     glm::vec3 leftCheck = position + perpendicular * effectiveRadius;
                     glm::vec3 rightCheck = position - perpendicular * effectiveRadius;
 
-                    float leftClearance = glm::length(otherMob->position - leftCheck);
-                    float rightClearance = glm::length(otherMob->position - rightCheck);
+                    float leftClearance = glm::length(otherPosition - leftCheck);
+                    float rightClearance = glm::length(otherPosition - rightCheck);
 
                     if (rightClearance > leftClearance) {
                         perpendicular = -perpendicular;
@@ -233,75 +233,723 @@ glm::vec3 MobEntity::calculateSteeringForce(const glm::vec3& targetPos, float av
     return seekForce;
 }
 
+glm::vec3 MobEntity::steerReciprocal(const glm::vec3& seekDirection) {
+    const std::vector<glm::vec3>& positions = storage->positions;
+    const std::vector<float>& radii = storage->radii;
+    const glm::vec3 position = positions[slot];
+    const float radius = radii[slot];
+    const float movementSpeed = getMovementSpeed();
+    const bool hasVelocities = storage->velocities.size() == storage->size();
+
+    // Anyone who could close the gap within the horizon, both of us at full speed. In a
+    // crowd the closest few are all nearby, so look there first and only widen if needed.
+    thread_local std::vector<uint32_t> neighbors;
+    thread_local std::vector<std::pair<float, uint32_t>> closest;
+    const float contact = radius + entityManager->getMaxMobRadius();
+    const float reach = contact + AVOIDANCE_TIME_HORIZON * movementSpeed * 2.0f;
+    const float nearReach = glm::min(reach, contact * 3.0f);
+    entityManager->queryRadius(position, nearReach, neighbors);
+    if (neighbors.size() <= AVOIDANCE_MAX_NEIGHBORS && nearReach < reach) {
+        entityManager->queryRadius(position, reach, neighbors);
+    }
+
+    closest.clear();
+    for (uint32_t other : neighbors) {
+        if (other == slot) continue;
+        glm::vec3 offset = positions[other] - position;
+        closest.push_back({offset.x * offset.x + offset.z * offset.z, other});
+    }
+    size_t count = std::min(closest.size(), AVOIDANCE_MAX_NEIGHBORS);
+    std::partial_sort(closest.begin(), closest.begin() + count, closest.end());
+
+    // PCs are steered by their players and will not make room for us
+    thread_local std::vector<OrcaNeighbor> orcaNeighbors;
+    orcaNeighbors.clear();
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t other = closest[i].second;
+        glm::vec3 otherVelocity = hasVelocities ? storage->velocities[other] : glm::vec3(0.0f);
+        orcaNeighbors.push_back({glm::vec2(positions[other].x, positions[other].z),
+                                 glm::vec2(otherVelocity.x, otherVelocity.z), radii[other],
+                                 storage->kinds[other] == EntityKind::Player ? 1.0f : 0.5f});
+    }
+
+    glm::vec3 velocity = hasVelocities ? storage->velocities[slot] : glm::vec3(0.0f);
+    glm::vec2 solved = solveOrcaVelocity(glm::vec2(position.x, position.z), glm::vec2(velocity.x, velocity.z), radius,
+                                         glm::vec2(seekDirection.x, seekDirection.z) * movementSpeed, movementSpeed,
+                                         orcaNeighbors.data(), orcaNeighbors.size(), AVOIDANCE_TIME_HORIZON,
+                                         glm::max(entityManager->getDeltaTime(), 0.001f));
+
+    // Back to a direction scaled by the fraction of full speed
+    return movementSpeed > 0.0f ? glm::vec3(solved.x, 0.0f, solved.y) / movementSpeed : glm::vec3(0.0f);
+}
+
+void BasicShooterEnemy::refreshDerivedStats() {
+    if (derivedStatsVersion == stats.getVersion()) return;
+
+    derivedStatsVersion = stats.getVersion();
+    avoidanceRadius = glm::max(3.0f, getMovementSpeed() * 0.8f); // Scale with speed
+    fireInterval = getAttackSpeed() > 0.0f ? 1.0f / getAttackSpeed() : 0.0f;
+}
+
 void BasicShooterEnemy::update(float deltaTime) {
-    // AI: Follow the closest player character using steering behaviors
-    if (party && !party->empty()) {
-        // Find the closest PC
-        std::shared_ptr<PlayerEntity> closestPC = nullptr;
-        float closestDistance = std::numeric_limits<float>::max();
-
-        for (const auto& pc : *party) {
-            if (pc && pc->active) {
-                float distance = glm::length(pc->position - position);
-                if (distance < closestDistance) {
-                    closestDistance = distance;
-                    closestPC = pc;
-                }
+    if (entityManager && storage) {
+        refreshDerivedStats();
+
+        // Decisions may be time-sliced; movement below runs every tick
+        AIScheduler& scheduler = entityManager->getAIScheduler();
+        if (scheduler.shouldThink(slot)) {
+            if (scheduler.isTiming()) {
+                auto start = std::chrono::steady_clock::now();
+                think();
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+                scheduler.recordThinkTime(static_cast<uint64_t>(elapsed.count()));
+            } else {
+                think();
             }
         }
 
-        // Use steering behaviors to move toward the closest PC
-        if (closestPC) {
-            glm::vec3 targetPos = closestPC->position;
-
-            // Desired engagement distance (stop a bit away from the player)
-            float desiredDistance = radius + closestPC->radius + 1.0f; // Keep some combat distance
-
-            if (closestDistance > desiredDistance) {
-                // Calculate steering direction with dynamic avoidance radius
-                float avoidanceRadius = glm::max(3.0f, movementSpeed * 0.8f); // Scale with speed
-                glm::vec3 steeringDir = calculateSteeringForce(targetPos, avoidanceRadius);
-
-                // Smoother movement using steering direction
-                glm::vec3 nextPos = position + steeringDir * movementSpeed * deltaTime;
-                moveTo(nextPos);
-            } else if (closestDistance < desiredDistance * 0.7f) {
-                // Too close, back away slightly
-                glm::vec3 awayDir = glm::normalize(position - targetPos);
-                glm::vec3 backPos = position + awayDir * movementSpeed * 0.5f * deltaTime;
-                moveTo(backPos);
+        // Keep heading the way the last decision pointed
+        const glm::vec3 position = getPosition();
+        const float movementSpeed = getMovementSpeed();
+        if (intent == Intent::Chase) {
+            // Neighbors' velocities change every tick, so the reciprocal solve is redone each tick
+            if (entityManager->getSteeringMode() == SteeringMode::Reciprocal) {
+                moveDirection = steerAlong(seekDirection, 0.0f);
+            }
+            moveTo(position + moveDirection * movementSpeed * deltaTime);
+        } else if (intent == Intent::BackAway) {
+            moveTo(position + moveDirection * movementSpeed * 0.5f * deltaTime);
+        } else if (intent == Intent::FollowPath && path) {
+            // Walk the waypoints straight, refining the next segment on arrival;
+            // think() re-routes if the path goes stale
+            bool heading = false;
+            while (!heading) {
+                if (pathWaypoint >= waypoints.size()) {
+                    if (pathSegment >= path->getSegmentCount()) break;
+                    waypoints.clear();
+                    entityManager->getPathService().refineSegment(*path, pathSegment++, waypoints);
+                    pathWaypoint = 0;
+                    continue;
+                }
+
+                glm::vec3 offset = waypoints[pathWaypoint] - position;
+                offset.y = 0.0f;
+                if (glm::length(offset) > WAYPOINT_REACHED_DISTANCE) {
+                    moveDirection = glm::normalize(offset);
+                    heading = true;
+                } else {
+                    pathWaypoint++;
+                }
+            }
+
+            if (heading) {
+                moveTo(position + moveDirection * movementSpeed * deltaTime);
             } else {
-                // We're at a good distance, stop moving but face the target
+                intent = Intent::Hold;
                 stop();
-                // Could add rotation to face target here if needed
             }
         }
+
+        fireAtTarget(deltaTime);
     }
 
     // Call parent update to handle movement
     MobEntity::update(deltaTime);
 }
 
-void EntityManager::addEntity(std::shared_ptr<Entity> entity) {
-    entities.push_back(entity);
+void BasicShooterEnemy::fireAtTarget(float deltaTime) {
+    fireCooldown = glm::max(0.0f, fireCooldown - deltaTime);
+    if (fireCooldown > 0.0f || getAttackSpeed() <= 0.0f || intent == Intent::FollowPath) return;
+
+    uint32_t targetSlot;
+    if (!entityManager->tryGetSlot(target, targetSlot) || !storage->active[targetSlot]) return;
+
+    const glm::vec3 position = getPosition();
+    const glm::vec3 targetPos = storage->positions[targetSlot];
+    glm::vec3 toTarget = targetPos - position;
+    toTarget.y = 0.0f;
+    float distance = glm::length(toTarget);
+    if (distance > FIRE_RANGE || distance < 0.001f) return;
+
+    // Walls stop projectiles; hold fire until there is a clear shot
+    const NavGrid& navGrid = entityManager->getNavGrid();
+    if (navGrid.hasObstacles() && !navGrid.lineOfSight(position, targetPos)) return;
+
+    ProjectileSystem::Shot shot;
+    shot.position = position;
+    shot.velocity = toTarget / distance * PROJECTILE_SPEED;
+    shot.lifetime = FIRE_RANGE / PROJECTILE_SPEED;
+    shot.radius = PROJECTILE_RADIUS;
+    shot.damage = PROJECTILE_DAMAGE;
+    shot.owner = handle;
+    shot.ownerKind = getKind();
+    entityManager->getProjectiles().fire(shot, slot);
+    fireCooldown = fireInterval;
+}
+
+void BasicShooterEnemy::think() {
+    if (!entityManager || !storage) return;
+
+    // AI: Follow the closest player character using steering behaviors
+    const std::vector<glm::vec3>& positions = storage->positions;
+    const glm::vec3 position = positions[slot];
+
+    uint32_t closestSlot = 0;
+    float closestDistance = std::numeric_limits<float>::max();
+    target = EntityHandle();
+
+    // The flow field already knows which PC is nearest; only look up where it is now
+    const FlowField& flowField = entityManager->getFlowField();
+    FlowField::Sample flow;
+    bool onFlowField = flowField.sample(position, flow);
+    if (onFlowField) {
+        EntityHandle pc = flowField.getGoals()[flow.goal].handle;
+        uint32_t pcSlot;
+        if (entityManager->tryGetSlot(pc, pcSlot) && storage->active[pcSlot]) {
+            closestDistance = glm::length(positions[pcSlot] - position);
+            closestSlot = pcSlot;
+            target = pc;
+        } else {
+            onFlowField = false;
+        }
+    }
+
+    // Off the field: find the closest PC ourselves
+    if (!onFlowField) {
+        for (EntityHandle pc : entityManager->getPlayerHandles()) {
+            uint32_t pcSlot;
+            if (entityManager->tryGetSlot(pc, pcSlot) && storage->active[pcSlot]) {
+                float distance = glm::length(positions[pcSlot] - position);
+                if (distance < closestDistance) {
+                    closestDistance = distance;
+                    closestSlot = pcSlot;
+                    target = pc;
+                }
+            }
+        }
+    }
+
+    // Use steering behaviors to move toward the closest PC
+    intent = Intent::Hold;
+    if (target.isValid()) {
+        glm::vec3 targetPos = positions[closestSlot];
+
+        // Desired engagement distance (stop a bit away from the player)
+        float desiredDistance = storage->radii[slot] + storage->radii[closestSlot] + 1.0f; // Keep some combat distance
+
+        if (closestDistance > desiredDistance && routeTo(targetPos)) {
+            // Out of sight behind an obstacle: follow the path around it
+            intent = Intent::FollowPath;
+        } else if (closestDistance > desiredDistance) {
+            // Follow the field from afar; its cell-sized steps are too coarse up close
+            seekDirection = onFlowField && flow.distance > FLOW_FIELD_SEEK_DISTANCE
+                ? flow.direction
+                : glm::normalize(targetPos - position);
+
+            // Smoother movement using steering direction, avoiding within a radius that
+            // scales with speed (update() steers reciprocal mode itself)
+            intent = Intent::Chase;
+            if (entityManager->getSteeringMode() == SteeringMode::Heuristic) {
+                moveDirection = steerAlong(seekDirection, avoidanceRadius);
+            }
+        } else if (closestDistance < desiredDistance * 0.7f) {
+            // Too close, back away slightly
+            intent = Intent::BackAway;
+            moveDirection = glm::normalize(position - targetPos);
+        } else {
+            // We're at a good distance, stop moving but face the target
+            stop();
+            // Could add rotation to face target here if needed
+        }
+    }
+}
+
+bool BasicShooterEnemy::routeTo(const glm::vec3& targetPos) {
+    const NavGrid& navGrid = entityManager->getNavGrid();
+    const glm::vec3 position = getPosition();
+    const int32_t goalCell = navGrid.cellIndex(targetPos);
+    if (!navGrid.hasObstacles() || goalCell < 0 || navGrid.cellIndex(position) < 0 ||
+        navGrid.lineOfSight(position, targetPos)) {
+        path.reset();
+        return false;
+    }
+
+    // Ask for a path to the target's current cell (once) when the one we
+    // hold leads elsewhere; keep walking the old one until the answer arrives
+    bool current = path && !path->stale && path->goalCell == goalCell;
+    if (!current && requestedGoalCell != goalCell) {
+        entityManager->getPathJobs().request(handle, position, targetPos, slot);
+        requestedGoalCell = goalCell;
+    }
+    if (path && path->stale) {
+        path.reset();
+    }
+    return path && path->found();
+}
+
+void BasicShooterEnemy::receivePath(std::shared_ptr<const PathService::Path> newPath) {
+    if (newPath && newPath->goalCell == requestedGoalCell) {
+        requestedGoalCell = -1;
+    }
+    // Went stale while waiting to be delivered: think() asks again
+    if (!newPath || newPath->stale) return;
+
+    path = std::move(newPath);
+    pathSegment = 0;
+    waypoints.clear();
+    pathWaypoint = 0;
+}
+
+void Entity::setActive(bool value) {
+    if (storage) {
+        storage->active[slot] = value ? 1 : 0;
+    } else {
+        detached.active = value;
+    }
+}
+
+EntityManager::~EntityManager() {
+    clear();
+}
+
+void EntityManager::clear() {
+    // Hand hot state back to any views that outlive the manager
+    for (auto& entity : entities) {
+        entity->detached = storage.read(entity->slot);
+        entity->storage = nullptr;
+        entity->handle = EntityHandle();
+        if (entity->isMob()) {
+            static_cast<MobEntity*>(entity.get())->entityManager = nullptr;
+        }
+    }
+
+    entities.clear();
+    storage.clear();
+    spatialGrid.clear();
+    spatialGridStale = false;
+    flowField.clear();
+    partyGoals.clear();
+    aiScheduler.reset();
+    sleepingCount = 0;
+
+    handleEntries.clear();
+    freeHandleHead = NO_FREE_HANDLE;
+    playerHandles.clear();
+    commands.clear();
+    pathJobs.clear();
+    projectiles.clear();
+    events.clear();
+    timers.clear();
+}
+
+void EntityManager::setActionState(Entity& entity, EntityState state, uint32_t ticks) {
+    timers.cancel(entity.stateTimer);
+    entity.stateTimer = TimerHandle();
+    entity.actionState = state;
+
+    if (ticks > 0) {
+        entity.stateTimer = timers.schedule(ticks, entity.handle, static_cast<uint32_t>(TimerTag::ActionState));
+    }
+}
+
+EntityHandle EntityManager::allocateHandle(uint32_t slot) {
+    uint32_t index;
+    if (freeHandleHead != NO_FREE_HANDLE) {
+        index = freeHandleHead;
+        freeHandleHead = handleEntries[index].slot;
+    } else if (handleEntries.size() <= EntityHandle::INDEX_MASK) {
+        index = static_cast<uint32_t>(handleEntries.size());
+        handleEntries.push_back({0, 1});
+    } else {
+        // Every index a handle can hold is live
+        return EntityHandle();
+    }
+
+    handleEntries[index].slot = slot;
+    return EntityHandle(index, handleEntries[index].generation);
+}
+
+void EntityManager::releaseHandle(EntityHandle handle) {
+    HandleEntry& entry = handleEntries[handle.index()];
+
+    // Bump the generation so outstanding copies of this handle go stale
+    entry.generation = (entry.generation + 1) & EntityHandle::GENERATION_MASK;
+    if (entry.generation == 0) {
+        entry.generation = 1;
+    }
+
+    entry.slot = freeHandleHead;
+    freeHandleHead = handle.index();
+}
+
+Entity* EntityManager::resolve(EntityHandle handle) const {
+    uint32_t slot;
+    return tryGetSlot(handle, slot) ? entities[slot].get() : nullptr;
+}
+
+bool EntityManager::tryGetSlot(EntityHandle handle, uint32_t& slot) const {
+    if (!handle.isValid() || handle.index() >= handleEntries.size()) return false;
+
+    const HandleEntry& entry = handleEntries[handle.index()];
+    if (entry.generation != handle.generation()) return false;
+
+    slot = entry.slot;
+    return true;
+}
+
+void EntityManager::reserve(size_t entityCount) {
+    entities.reserve(entityCount);
+    storage.reserve(entityCount);
+    handleEntries.reserve(entityCount);
+}
+
+EntityHandle EntityManager::addEntity(std::shared_ptr<Entity> entity, uint32_t order) {
+    if (!entity || entity->storage) return EntityHandle();
+
+    if (updating) {
+        commands.spawn(std::move(entity), order);
+        return EntityHandle();
+    }
+
+    return attachEntity(std::move(entity));
+}
+
+EntityHandle EntityManager::attachEntity(std::shared_ptr<Entity> entity) {
+    EntityHandle handle = allocateHandle(storage.size());
+    if (!handle.isValid()) {
+        std::cerr << "Entity handle table is full; spawn refused" << std::endl;
+        return handle;
+    }
+
+    // Move the staged hot state into the storage arrays and bind the view
+    entity->slot = storage.push(entity->detached);
+    entity->storage = &storage;
+    entity->handle = handle;
+    spatialGridStale = true;
 
     // Set entity manager reference for MobEntity types (for collision detection)
-    if (auto mob = std::dynamic_pointer_cast<MobEntity>(entity)) {
-        mob->entityManager = this;
+    if (entity->isMob()) {
+        static_cast<MobEntity*>(entity.get())->entityManager = this;
+    }
+    if (entity->getKind() == EntityKind::Player) {
+        playerHandles.push_back(entity->handle);
+    }
+
+    entities.push_back(std::move(entity));
+    return handle;
+}
+
+const SpatialHashGrid& EntityManager::currentSpatialGrid() const {
+    // Never stale while updateAll runs (it rebuilds first and defers structural
+    // changes), so worker threads querying mid-tick do not race on this.
+    // Moves made by a sequential tick are picked up once it is over.
+    if (spatialGridStale || (!updating && storage.positionEdits != spatialGridPositionEdits)) {
+        spatialGrid.rebuild(storage);
+        spatialGridStale = false;
+        spatialGridPositionEdits = storage.positionEdits;
     }
+    return spatialGrid;
+}
+
+void EntityManager::queryRadius(const glm::vec3& position, float radius, std::vector<uint32_t>& results) const {
+    currentSpatialGrid().queryRadius(position, radius, results);
+}
+
+bool EntityManager::sweepCircle(const glm::vec3& start, const glm::vec3& end, float radius, uint32_t ignoreSlot,
+                                SpatialHashGrid::SweepHit& hit) const {
+    return currentSpatialGrid().sweepCircle(start, end, radius, ignoreSlot, hit);
+}
+
+void EntityManager::queryRadius(const glm::vec3& position, float radius, EntityKindMask kinds,
+                                std::vector<uint32_t>& results) const {
+    currentSpatialGrid().queryRadius(position, radius, kinds, results);
+}
+
+void EntityManager::queryKNearest(const glm::vec3& position, size_t k, float maxDistance, EntityKindMask kinds,
+                                  std::vector<uint32_t>& results) const {
+    currentSpatialGrid().queryKNearest(position, k, maxDistance, kinds, results);
+}
+
+void EntityManager::queryAABB(const glm::vec3& minCorner, const glm::vec3& maxCorner, EntityKindMask kinds,
+                              std::vector<uint32_t>& results) const {
+    currentSpatialGrid().queryAABB(minCorner, maxCorner, kinds, results);
+}
+
+bool EntityManager::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                            EntityKindMask kinds, SpatialHashGrid::RayHit& hit, uint32_t ignoreSlot) const {
+    return currentSpatialGrid().raycast(origin, direction, maxDistance, kinds, ignoreSlot, hit);
 }
 
 void EntityManager::removeEntity(std::shared_ptr<Entity> entity) {
-    entities.erase(
-        std::remove(entities.begin(), entities.end(), entity),
-        entities.end()
-    );
+    if (!entity || entity->storage != &storage) return;
+    removeEntity(entity->handle);
+}
+
+void EntityManager::removeEntity(EntityHandle handle) {
+    if (updating) {
+        commands.despawn(handle);
+        return;
+    }
+
+    uint32_t slot;
+    if (tryGetSlot(handle, slot)) {
+        removeAtSlot(slot);
+    }
+}
+
+void EntityManager::removeAtSlot(uint32_t slot) {
+    std::shared_ptr<Entity> entity = entities[slot];
+
+    if (entity->getKind() == EntityKind::Player) {
+        playerHandles.erase(std::remove(playerHandles.begin(), playerHandles.end(), entity->handle), playerHandles.end());
+    }
+    releaseHandle(entity->handle);
+    timers.cancel(entity->stateTimer);
+    entity->stateTimer = TimerHandle();
+
+    // Copy the hot state back so the detached entity stays readable
+    entity->detached = storage.read(slot);
+    entity->storage = nullptr;
+    entity->handle = EntityHandle();
+    if (entity->isMob()) {
+        static_cast<MobEntity*>(entity.get())->entityManager = nullptr;
+    }
+
+    // Swap the last entity into the freed slot to keep storage dense
+    uint32_t moved = storage.swapRemove(slot);
+    spatialGridStale = true;
+    if (moved != slot) {
+        entities[slot] = std::move(entities[moved]);
+        entities[slot]->slot = slot;
+        handleEntries[entities[slot]->handle.index()].slot = slot;
+    }
+    entities.pop_back();
+}
+
+void EntityManager::setUpdateMode(UpdateMode mode, size_t workerThreads) {
+    updateMode = mode;
+
+    if (mode == UpdateMode::Parallel) {
+        if (workerThreads == 0) {
+            unsigned int hardwareThreads = std::thread::hardware_concurrency();
+            workerThreads = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+        }
+        if (!threadPool || threadPool->getThreadCount() != workerThreads + 1) {
+            threadPool = std::make_unique<ThreadPool>(workerThreads);
+        }
+    } else {
+        threadPool.reset();
+    }
+}
+
+void EntityManager::setFlowFieldEnabled(bool enabled) {
+    flowFieldEnabled = enabled;
+    if (!enabled) {
+        flowField.clear();
+    }
+}
+
+void EntityManager::setSleepEnabled(bool enabled) {
+    sleepEnabled = enabled;
+    if (!enabled) {
+        std::fill(storage.sleeping.begin(), storage.sleeping.end(), 0);
+        std::fill(storage.stillTicks.begin(), storage.stillTicks.end(), 0);
+        sleepingCount = 0;
+    }
+}
+
+void EntityManager::updateSleepStates() {
+    if (!sleepEnabled) return;
+
+    const uint32_t count = storage.size();
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        if (!isMobKind(storage.kinds[slot]) || !storage.active[slot]) continue;
+
+        // Anything that moved (or wants to) resets the count and disturbs its neighbors
+        glm::vec3 lastStep = storage.positions[slot] - storage.previousPositions[slot];
+        if (storage.moving[slot] || glm::dot(lastStep, lastStep) > SLEEP_EPSILON * SLEEP_EPSILON) {
+            storage.stillTicks[slot] = 0;
+            storage.sleeping[slot] = 0;
+        } else if (storage.stillTicks[slot] < SLEEP_DELAY) {
+            if (++storage.stillTicks[slot] == SLEEP_DELAY) {
+                storage.sleeping[slot] = 1;
+            }
+        }
+    }
+}
+
+void EntityManager::wakeDisturbedSleepers() {
+    sleepingCount = 0;
+    if (!sleepEnabled) return;
+
+    const uint32_t count = storage.size();
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        if (!storage.sleeping[slot] || !storage.active[slot]) continue;
+
+        if (spatialGrid.isNeighborhoodDisturbed(storage.positions[slot])) {
+            // Awake, but being pushed is not itself a disturbance until we move
+            storage.sleeping[slot] = 0;
+            storage.stillTicks[slot] = 1;
+        } else {
+            sleepingCount++;
+        }
+    }
+}
+
+void EntityManager::applyCommands() {
+    {
+        std::lock_guard<std::mutex> lock(commands.mutex);
+        pendingSpawns.swap(commands.spawns);
+        pendingDespawns.swap(commands.despawns);
+    }
+
+    // Despawn in handle order; duplicates and stale handles fall out naturally
+    std::sort(pendingDespawns.begin(), pendingDespawns.end(), [](EntityHandle a, EntityHandle b) {
+        return a.value < b.value;
+    });
+    for (EntityHandle handle : pendingDespawns) {
+        uint32_t slot;
+        if (tryGetSlot(handle, slot)) {
+            removeAtSlot(slot);
+        }
+    }
+
+    std::stable_sort(pendingSpawns.begin(), pendingSpawns.end(), [](const auto& a, const auto& b) {
+        return a.order < b.order;
+    });
+    for (auto& command : pendingSpawns) {
+        if (!command.entity->storage) {
+            attachEntity(std::move(command.entity));
+        }
+    }
+
+    pendingSpawns.clear();
+    pendingDespawns.clear();
 }
 
 void EntityManager::updateAll(float deltaTime) {
-    for (auto& entity : entities) {
-        if (entity && entity->active) {
-            entity->update(deltaTime);
+    tickDeltaTime = deltaTime;
+
+    // Timers due this tick: timed states end here, the rest go out as events
+    expiredTimers.clear();
+    timers.advance(1, expiredTimers);
+    for (const TimerWheel::Expiry& expiry : expiredTimers) {
+        if (expiry.tag == static_cast<uint32_t>(TimerTag::ActionState)) {
+            Entity* entity = resolve(expiry.entity);
+            if (entity && entity->stateTimer == expiry.timer) {
+                entity->actionState = EntityState::Idle;
+                entity->stateTimer = TimerHandle();
+            }
+        } else if (events.isWanted<TimerEvent>()) {
+            events.publish(TimerEvent{expiry.timer, expiry.entity, static_cast<TimerTag>(expiry.tag), expiry.data});
+        }
+    }
+
+    // Drop cached paths through cells that opened or closed since last tick
+    if (!navGrid.getChangedCells().empty()) {
+        pathService.invalidate(navGrid.getChangedCells());
+        navGrid.clearChangedCells();
+    }
+
+    // Path searches requested last tick run in the background from here on
+    pathJobs.beginTick();
+
+    // Shared paths toward the party; only recomputed when a PC changes cell
+    partyGoals.clear();
+    for (EntityHandle pc : playerHandles) {
+        uint32_t pcSlot;
+        if (tryGetSlot(pc, pcSlot) && storage.active[pcSlot]) {
+            partyGoals.push_back({pc, storage.positions[pcSlot]});
         }
     }
+    if (flowFieldEnabled) {
+        flowField.update(partyGoals);
+    }
+
+    // Choose which enemies make decisions this tick (reads last tick's movement)
+    aiScheduler.plan(entities, storage, flowField, partyGoals);
+    updateSleepStates();
+
+    // Reciprocal avoidance predicts neighbors from how they moved last tick
+    if (steeringMode == SteeringMode::Reciprocal) {
+        storage.captureVelocities(deltaTime);
+    }
+    storage.capturePreviousPositions();
+
+    // Bucket mobs once per tick so neighbor queries stay local
+    spatialGrid.rebuild(storage);
+    spatialGridStale = false;
+    spatialGridPositionEdits = storage.positionEdits;
+    wakeDisturbedSleepers();
+
+    updating = true;
+
+    if (updateMode == UpdateMode::Sequential) {
+        for (auto& entity : entities) {
+            if (entity->isActive()) {
+                entity->update(deltaTime);
+            }
+        }
+    } else {
+        // Every mob reads the frozen positions and writes only its own next slot
+        storage.beginDoubleBuffer();
+        threadPool->parallelFor(entities.size(), 64, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Entity& entity = *entities[i];
+                if (entity.isActive()) {
+                    entity.update(deltaTime);
+                }
+            }
+        });
+        storage.endDoubleBuffer();
+    }
+
+    updating = false;
+
+    // Move projectiles against where the mobs ended up and apply their hits.
+    // The grid from the start of the tick buckets mobs where they were, so it
+    // is rebuilt first; slots do not change before applyCommands.
+    projectileHits.clear();
+    const bool gridRebuilt = projectiles.getCount() > 0 || projectiles.hasQueuedShots();
+    if (gridRebuilt) {
+        spatialGrid.rebuild(storage);
+        spatialGridStale = false;
+        spatialGridPositionEdits = storage.positionEdits;
+        projectiles.update(deltaTime, spatialGrid, storage, &navGrid, projectileHits);
+    }
+    const bool publishDamage = events.isWanted<DamageEvent>();
+    const bool publishDeaths = events.isWanted<DeathEvent>();
+    for (const ProjectileSystem::Hit& hit : projectileHits) {
+        MobEntity* mob = static_cast<MobEntity*>(entities[hit.slot].get());
+        bool wasAlive = mob->health > 0.0f;
+        mob->applyDamage(hit.damage);
+        if (publishDamage) {
+            events.publish(DamageEvent{hit.owner, mob->handle, hit.damage, mob->health, hit.position});
+        }
+        if (publishDeaths && wasAlive && mob->health <= 0.0f) {
+            events.publish(DeathEvent{mob->handle, hit.owner, hit.position});
+        }
+    }
+
+    // Sync point: apply structural changes recorded during the tick
+    applyCommands();
+
+    // Hand finished path searches to the mobs that asked for them
+    pathResults.clear();
+    pathJobs.endTick(pathResults);
+    for (PathJobQueue::Result& result : pathResults) {
+        Entity* entity = resolve(result.requester);
+        if (entity && entity->isMob()) {
+            static_cast<MobEntity*>(entity)->receivePath(std::move(result.path));
+        }
+    }
+
+    // Mobs have moved off the cells they were bucketed in, unless the grid was
+    // rebuilt for the projectiles (spawns and despawns mark it stale themselves)
+    if (!gridRebuilt) {
+        spatialGridStale = true;
+    }
+
+    // Sync point for gameplay events; handlers may add and remove entities directly
+    events.dispatch();
 }
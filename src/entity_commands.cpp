@@ -0,0 +1,26 @@
+#include "entity_commands.h"
+
+void EntityCommandBuffer::spawn(std::shared_ptr<Entity> entity, uint32_t order) {
+    if (!entity) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    spawns.push_back({std::move(entity), order});
+}
+
+void EntityCommandBuffer::despawn(EntityHandle handle) {
+    if (!handle.isValid()) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    despawns.push_back(handle);
+}
+
+bool EntityCommandBuffer::empty() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return spawns.empty() && despawns.empty();
+}
+
+void EntityCommandBuffer::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    spawns.clear();
+    despawns.clear();
+}
@@ -0,0 +1,55 @@
+#include "entity_pool.h"
+#include <algorithm>
+
+SlabPool::SlabPool(size_t blockSize, size_t blockAlignment, size_t blocksPerSlab)
+    : blockSize(0)
+    , blockAlignment(std::max(blockAlignment, alignof(FreeBlock)))
+    , blocksPerSlab(blocksPerSlab)
+    , liveBlocks(0)
+    , freeList(nullptr)
+{
+    // Every block must hold a free-list link and keep the next block aligned
+    size_t size = std::max(blockSize, sizeof(FreeBlock));
+    this->blockSize = (size + this->blockAlignment - 1) / this->blockAlignment * this->blockAlignment;
+}
+
+SlabPool::~SlabPool() {
+    for (void* slab : slabs) {
+        ::operator delete(slab, std::align_val_t(blockAlignment));
+    }
+}
+
+void SlabPool::addSlab() {
+    auto* slab = static_cast<unsigned char*>(::operator new(blockSize * blocksPerSlab, std::align_val_t(blockAlignment)));
+    slabs.push_back(slab);
+
+    // Thread the new blocks onto the free list in address order
+    for (size_t i = blocksPerSlab; i > 0; --i) {
+        auto* block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * blockSize);
+        block->next = freeList;
+        freeList = block;
+    }
+}
+
+void* SlabPool::allocate() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!freeList) {
+        addSlab();
+    }
+
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    liveBlocks++;
+    return block;
+}
+
+void SlabPool::deallocate(void* block) {
+    if (!block) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto* freed = static_cast<FreeBlock*>(block);
+    freed->next = freeList;
+    freeList = freed;
+    liveBlocks--;
+}
@@ -0,0 +1,428 @@
+#include "entity.h"
+#include "entity_snapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ACTIONRPG_HAS_MMAP 1
+#endif
+
+namespace {
+
+const char SNAPSHOT_MAGIC[4] = {'A', 'R', 'P', 'S'};
+
+size_t alignUp(size_t offset) {
+    return (offset + SNAPSHOT_ALIGNMENT - 1) & ~(SNAPSHOT_ALIGNMENT - 1);
+}
+
+// Byte offset of every section for the given counts
+struct SnapshotLayout {
+    size_t positions;
+    size_t previousPositions;
+    size_t targetPositions;
+    size_t radii;
+    size_t moving;
+    size_t active;
+    size_t kinds;
+    size_t stillTicks;
+    size_t sleeping;
+    size_t records;
+    size_t handles;
+    size_t players;
+    size_t end;
+};
+
+SnapshotLayout computeLayout(size_t entityCount, size_t handleCount, size_t handleEntrySize, size_t playerCount) {
+    SnapshotLayout layout;
+    size_t offset = sizeof(SnapshotHeader);
+    auto section = [&](size_t bytes) {
+        size_t start = alignUp(offset);
+        offset = start + bytes;
+        return start;
+    };
+
+    layout.positions = section(entityCount * sizeof(glm::vec3));
+    layout.previousPositions = section(entityCount * sizeof(glm::vec3));
+    layout.targetPositions = section(entityCount * sizeof(glm::vec3));
+    layout.radii = section(entityCount * sizeof(float));
+    layout.moving = section(entityCount);
+    layout.active = section(entityCount);
+    layout.kinds = section(entityCount * sizeof(EntityKind));
+    layout.stillTicks = section(entityCount);
+    layout.sleeping = section(entityCount);
+    layout.records = section(entityCount * sizeof(SnapshotEntityRecord));
+    layout.handles = section(handleCount * handleEntrySize);
+    layout.players = section(playerCount * sizeof(uint32_t));
+    layout.end = offset;
+    return layout;
+}
+
+// Sequential writer that zero-pads up to each section's offset
+class SectionWriter {
+public:
+    explicit SectionWriter(FILE* file) : file(file), written(0), failed(false) {}
+
+    void write(size_t offset, const void* data, size_t bytes) {
+        static const char zeros[SNAPSHOT_ALIGNMENT] = {};
+        if (offset > written) {
+            failed |= fwrite(zeros, 1, offset - written, file) != offset - written;
+            written = offset;
+        }
+        if (bytes > 0) {
+            failed |= fwrite(data, 1, bytes, file) != bytes;
+            written += bytes;
+        }
+    }
+
+    bool ok() const { return !failed; }
+
+private:
+    FILE* file;
+    size_t written;
+    bool failed;
+};
+
+// Read-only view of a whole file: mmap where available, otherwise read into memory
+class MappedFile {
+public:
+    MappedFile() : bytes(nullptr), length(0) {}
+    ~MappedFile() {
+#ifdef ACTIONRPG_HAS_MMAP
+        if (bytes && buffer.empty()) {
+            munmap(const_cast<uint8_t*>(bytes), length);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+#ifdef ACTIONRPG_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        length = static_cast<size_t>(info.st_size);
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) return false;
+
+        // The whole file is copied out front to back
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        bytes = static_cast<const uint8_t*>(mapped);
+        return true;
+#else
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) return false;
+
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (size <= 0) {
+            fclose(file);
+            return false;
+        }
+
+        buffer.resize(static_cast<size_t>(size));
+        bool complete = fread(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        fclose(file);
+        if (!complete) return false;
+
+        bytes = buffer.data();
+        length = buffer.size();
+        return true;
+#endif
+    }
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* bytes;
+    size_t length;
+    std::vector<uint8_t> buffer; // Fallback copy when not memory-mapped
+};
+
+template <typename T>
+void copySection(std::vector<T>& target, const uint8_t* base, size_t offset, size_t count) {
+    target.resize(count);
+    if (count > 0) {
+        std::memcpy(target.data(), base + offset, count * sizeof(T));
+    }
+}
+
+template <typename T>
+std::shared_ptr<Entity> makePooled() {
+    return std::allocate_shared<T>(PoolAllocator<T>());
+}
+
+EntityKind kindOf(SnapshotEntityType type) {
+    switch (type) {
+        case SnapshotEntityType::PlayerEntity: return EntityKind::Player;
+        case SnapshotEntityType::EnemyEntity:
+        case SnapshotEntityType::BasicShooterEnemy: return EntityKind::Enemy;
+        case SnapshotEntityType::Entity: break;
+    }
+    return EntityKind::Basic;
+}
+
+} // namespace
+
+bool EntityManager::saveSnapshot(const std::string& path) const {
+    if (updating) return false;
+
+    const uint32_t count = storage.size();
+    SnapshotLayout layout = computeLayout(count, handleEntries.size(), sizeof(HandleEntry), playerHandles.size());
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.entityCount = count;
+    header.handleCount = static_cast<uint32_t>(handleEntries.size());
+    header.playerCount = static_cast<uint32_t>(playerHandles.size());
+    header.freeHandleHead = freeHandleHead;
+    header.fileSize = layout.end;
+
+    // Cold fields and concrete type of every entity, in slot order
+    std::vector<SnapshotEntityRecord> records(count);
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        const Entity& entity = *entities[slot];
+        SnapshotEntityRecord& record = records[slot];
+        record = SnapshotEntityRecord{};
+        record.stateTicksRemaining = timers.getRemaining(entity.stateTimer);
+        record.rotation = entity.rotation;
+        record.scale = entity.scale;
+        record.color = entity.color;
+        record.actionState = static_cast<uint8_t>(entity.actionState);
+        record.type = SnapshotEntityType::Entity;
+
+        if (entity.isMob()) {
+            const MobEntity& mob = static_cast<const MobEntity&>(entity);
+            record.health = mob.health;
+            record.maxHealth = mob.stats.getBase(Stat::MaxHealth);
+            record.energy = mob.energy;
+            record.maxEnergy = mob.stats.getBase(Stat::MaxEnergy);
+            record.movementSpeed = mob.stats.getBase(Stat::MovementSpeed);
+            record.attackSpeed = mob.stats.getBase(Stat::AttackSpeed);
+        }
+
+        if (entity.getKind() == EntityKind::Player) {
+            record.type = SnapshotEntityType::PlayerEntity;
+        } else if (entity.getKind() == EntityKind::Enemy) {
+            // Not on the hot path; the kind tag does not tell enemy subclasses apart
+            if (auto shooter = dynamic_cast<const BasicShooterEnemy*>(&entity)) {
+                record.type = SnapshotEntityType::BasicShooterEnemy;
+                record.target = shooter->target.value;
+                record.intent = static_cast<uint8_t>(shooter->intent);
+                record.moveDirection = shooter->moveDirection;
+                record.seekDirection = shooter->seekDirection;
+                record.fireCooldown = shooter->fireCooldown;
+            } else {
+                record.type = SnapshotEntityType::EnemyEntity;
+            }
+        }
+    }
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Failed to open snapshot file: " << path << std::endl;
+        return false;
+    }
+
+    SectionWriter writer(file);
+    writer.write(0, &header, sizeof(header));
+    writer.write(layout.positions, storage.positions.data(), count * sizeof(glm::vec3));
+    writer.write(layout.previousPositions, storage.previousPositions.data(), count * sizeof(glm::vec3));
+    writer.write(layout.targetPositions, storage.targetPositions.data(), count * sizeof(glm::vec3));
+    writer.write(layout.radii, storage.radii.data(), count * sizeof(float));
+    writer.write(layout.moving, storage.moving.data(), count);
+    writer.write(layout.active, storage.active.data(), count);
+    writer.write(layout.kinds, storage.kinds.data(), count * sizeof(EntityKind));
+    writer.write(layout.stillTicks, storage.stillTicks.data(), count);
+    writer.write(layout.sleeping, storage.sleeping.data(), count);
+    writer.write(layout.records, records.data(), count * sizeof(SnapshotEntityRecord));
+    writer.write(layout.handles, handleEntries.data(), handleEntries.size() * sizeof(HandleEntry));
+    writer.write(layout.players, playerHandles.data(), playerHandles.size() * sizeof(uint32_t));
+
+    bool ok = writer.ok();
+    ok &= fclose(file) == 0;
+    if (!ok) {
+        std::cerr << "Failed to write snapshot: " << path << std::endl;
+    }
+    return ok;
+}
+
+bool EntityManager::loadSnapshot(const std::string& path) {
+    if (updating) return false;
+
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Failed to open snapshot file: " << path << std::endl;
+        return false;
+    }
+
+    // Validate everything before touching the current state
+    SnapshotHeader header;
+    if (file.size() < sizeof(header)) {
+        std::cerr << "Invalid snapshot file: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.byteOrder != SNAPSHOT_BYTE_ORDER) {
+        std::cerr << "Invalid snapshot file (bad magic or byte order): " << path << std::endl;
+        return false;
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        std::cerr << "Unsupported snapshot version " << header.version << " (expected " << SNAPSHOT_VERSION << ")"
+                  << std::endl;
+        return false;
+    }
+
+    const uint32_t count = header.entityCount;
+    SnapshotLayout layout = computeLayout(count, header.handleCount, sizeof(HandleEntry), header.playerCount);
+    if (header.fileSize != layout.end || file.size() < layout.end) {
+        std::cerr << "Truncated snapshot file: " << path << std::endl;
+        return false;
+    }
+
+    const uint8_t* base = file.data();
+    const auto* records = reinterpret_cast<const SnapshotEntityRecord*>(base + layout.records);
+    const auto* kinds = reinterpret_cast<const EntityKind*>(base + layout.kinds);
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        if (static_cast<uint8_t>(records[slot].type) > static_cast<uint8_t>(SnapshotEntityType::BasicShooterEnemy) ||
+            kindOf(records[slot].type) != kinds[slot]) {
+            std::cerr << "Corrupt snapshot entity " << slot << " in " << path << std::endl;
+            return false;
+        }
+    }
+
+    // Handle table: the free list must stay inside the table without looping,
+    // and every other entry must own exactly one slot
+    std::vector<HandleEntry> loadedHandles;
+    copySection(loadedHandles, base, layout.handles, header.handleCount);
+    std::vector<uint8_t> freeEntries(header.handleCount, 0);
+    bool handlesValid = header.handleCount <= EntityHandle::INDEX_MASK + 1;
+    for (uint32_t index = header.freeHandleHead; handlesValid && index != NO_FREE_HANDLE;
+         index = loadedHandles[index].slot) {
+        if (index >= header.handleCount || freeEntries[index]) {
+            handlesValid = false;
+        } else {
+            freeEntries[index] = 1;
+        }
+    }
+
+    std::vector<EntityHandle> slotHandles(count);
+    uint32_t liveCount = 0;
+    for (uint32_t index = 0; handlesValid && index < header.handleCount; ++index) {
+        if (freeEntries[index]) continue;
+
+        const HandleEntry& entry = loadedHandles[index];
+        if (entry.slot >= count || slotHandles[entry.slot].isValid() || entry.generation == 0 ||
+            entry.generation > EntityHandle::GENERATION_MASK) {
+            handlesValid = false;
+        } else {
+            slotHandles[entry.slot] = EntityHandle(index, entry.generation);
+            liveCount++;
+        }
+    }
+    handlesValid = handlesValid && liveCount == count;
+
+    // Player handles must resolve to PCs
+    std::vector<EntityHandle> loadedPlayers(header.playerCount);
+    for (uint32_t i = 0; handlesValid && i < header.playerCount; ++i) {
+        std::memcpy(&loadedPlayers[i].value, base + layout.players + i * sizeof(uint32_t), sizeof(uint32_t));
+        const EntityHandle pc = loadedPlayers[i];
+        if (pc.index() >= header.handleCount || freeEntries[pc.index()] ||
+            loadedHandles[pc.index()].generation != pc.generation() ||
+            kinds[loadedHandles[pc.index()].slot] != EntityKind::Player) {
+            handlesValid = false;
+        }
+    }
+
+    if (!handlesValid) {
+        std::cerr << "Corrupt snapshot handle table in " << path << std::endl;
+        return false;
+    }
+
+    clear();
+
+    // Hot arrays: one bulk copy each
+    copySection(storage.positions, base, layout.positions, count);
+    copySection(storage.previousPositions, base, layout.previousPositions, count);
+    copySection(storage.targetPositions, base, layout.targetPositions, count);
+    copySection(storage.radii, base, layout.radii, count);
+    copySection(storage.moving, base, layout.moving, count);
+    copySection(storage.active, base, layout.active, count);
+    copySection(storage.kinds, base, layout.kinds, count);
+    copySection(storage.stillTicks, base, layout.stillTicks, count);
+    copySection(storage.sleeping, base, layout.sleeping, count);
+    handleEntries = std::move(loadedHandles);
+    freeHandleHead = header.freeHandleHead;
+    playerHandles = std::move(loadedPlayers);
+
+    // Recreate the views; only cold fields are set per entity
+    entities.reserve(count);
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        const SnapshotEntityRecord& record = records[slot];
+
+        std::shared_ptr<Entity> entity;
+        switch (record.type) {
+            case SnapshotEntityType::Entity: entity = makePooled<Entity>(); break;
+            case SnapshotEntityType::PlayerEntity: entity = makePooled<PlayerEntity>(); break;
+            case SnapshotEntityType::EnemyEntity: entity = makePooled<EnemyEntity>(); break;
+            case SnapshotEntityType::BasicShooterEnemy: entity = makePooled<BasicShooterEnemy>(); break;
+        }
+
+        entity->rotation = record.rotation;
+        entity->scale = record.scale;
+        entity->color = record.color;
+        entity->actionState = static_cast<EntityState>(record.actionState);
+
+        if (entity->isMob()) {
+            MobEntity& mob = static_cast<MobEntity&>(*entity);
+            mob.health = record.health;
+            mob.stats.setBase(Stat::MaxHealth, record.maxHealth);
+            mob.energy = record.energy;
+            mob.stats.setBase(Stat::MaxEnergy, record.maxEnergy);
+            mob.stats.setBase(Stat::MovementSpeed, record.movementSpeed);
+            mob.stats.setBase(Stat::AttackSpeed, record.attackSpeed);
+            mob.entityManager = this;
+        }
+        if (record.type == SnapshotEntityType::BasicShooterEnemy) {
+            BasicShooterEnemy& shooter = static_cast<BasicShooterEnemy&>(*entity);
+            shooter.target.value = record.target;
+            shooter.intent = static_cast<BasicShooterEnemy::Intent>(record.intent);
+            shooter.moveDirection = record.moveDirection;
+            shooter.seekDirection = record.seekDirection;
+            shooter.fireCooldown = record.fireCooldown;
+        }
+
+        entity->storage = &storage;
+        entity->slot = slot;
+        entity->handle = slotHandles[slot];
+        if (record.stateTicksRemaining > 0) {
+            setActionState(*entity, entity->actionState,
+                           static_cast<uint32_t>(std::min<uint64_t>(record.stateTicksRemaining, UINT32_MAX)));
+        }
+        entities.push_back(std::move(entity));
+    }
+
+    // clear() left the grid marked fresh for an empty world
+    spatialGridStale = true;
+    return true;
+}
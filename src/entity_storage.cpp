@@ -0,0 +1,97 @@
+#include "entity_storage.h"
+
+uint32_t EntityStorage::push(const EntityHotState& state) {
+    uint32_t slot = size();
+    positions.push_back(state.position);
+    previousPositions.push_back(state.position);
+    targetPositions.push_back(state.targetPosition);
+    radii.push_back(state.radius);
+    moving.push_back(state.moving ? 1 : 0);
+    active.push_back(state.active ? 1 : 0);
+    kinds.push_back(state.kind);
+    stillTicks.push_back(0);
+    sleeping.push_back(0);
+    return slot;
+}
+
+EntityHotState EntityStorage::read(uint32_t slot) const {
+    EntityHotState state;
+    state.position = positions[slot];
+    state.targetPosition = targetPositions[slot];
+    state.radius = radii[slot];
+    state.moving = moving[slot] != 0;
+    state.active = active[slot] != 0;
+    state.kind = kinds[slot];
+    return state;
+}
+
+uint32_t EntityStorage::swapRemove(uint32_t slot) {
+    uint32_t last = size() - 1;
+    if (slot != last) {
+        positions[slot] = positions[last];
+        previousPositions[slot] = previousPositions[last];
+        targetPositions[slot] = targetPositions[last];
+        radii[slot] = radii[last];
+        moving[slot] = moving[last];
+        active[slot] = active[last];
+        kinds[slot] = kinds[last];
+        stillTicks[slot] = stillTicks[last];
+        sleeping[slot] = sleeping[last];
+    }
+
+    positions.pop_back();
+    previousPositions.pop_back();
+    targetPositions.pop_back();
+    radii.pop_back();
+    moving.pop_back();
+    active.pop_back();
+    kinds.pop_back();
+    stillTicks.pop_back();
+    sleeping.pop_back();
+    return last;
+}
+
+void EntityStorage::reserve(size_t count) {
+    positions.reserve(count);
+    previousPositions.reserve(count);
+    targetPositions.reserve(count);
+    radii.reserve(count);
+    moving.reserve(count);
+    active.reserve(count);
+    kinds.reserve(count);
+    stillTicks.reserve(count);
+    sleeping.reserve(count);
+}
+
+void EntityStorage::clear() {
+    positions.clear();
+    previousPositions.clear();
+    nextPositions.clear();
+    velocities.clear();
+    targetPositions.clear();
+    radii.clear();
+    moving.clear();
+    active.clear();
+    kinds.clear();
+    stillTicks.clear();
+    sleeping.clear();
+}
+
+void EntityStorage::beginDoubleBuffer() {
+    // Entities that do not move this tick keep their position
+    nextPositions = positions;
+    doubleBuffered = true;
+}
+
+void EntityStorage::endDoubleBuffer() {
+    positions.swap(nextPositions);
+    doubleBuffered = false;
+}
+
+void EntityStorage::captureVelocities(float deltaTime) {
+    velocities.resize(positions.size());
+    const float invDeltaTime = deltaTime > 0.0f ? 1.0f / deltaTime : 0.0f;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        velocities[i] = (positions[i] - previousPositions[i]) * invDeltaTime;
+    }
+}
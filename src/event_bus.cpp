@@ -0,0 +1,125 @@
+#include "event_bus.h"
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+std::atomic<uint32_t> registeredEventTypes{0};
+std::atomic<uint64_t> nextBusId{1};
+
+// Buses a thread has published to recently; 0 marks an unused entry
+struct ProducerCacheEntry {
+    uint64_t busId;
+    void* producer;
+};
+constexpr size_t PRODUCER_CACHE_SIZE = 8;
+
+} // namespace
+
+EventBus::EventBus()
+    : busId(nextBusId.fetch_add(1))
+    , producerCount(0)
+    , wanted{}
+    , publishedCount(0)
+    , dispatchedCount(0)
+{
+}
+
+uint32_t EventBus::registerEventType() {
+    const uint32_t id = registeredEventTypes.fetch_add(1);
+    // Every bus has fixed tables of MAX_EVENT_TYPES entries
+    if (id >= MAX_EVENT_TYPES) {
+        std::cerr << "EventBus: more than " << MAX_EVENT_TYPES << " event types" << std::endl;
+        std::abort();
+    }
+    return id;
+}
+
+EventBus::Producer* EventBus::localProducer() {
+    thread_local ProducerCacheEntry cache[PRODUCER_CACHE_SIZE] = {};
+    thread_local size_t nextEntry = 0;
+
+    for (const ProducerCacheEntry& entry : cache) {
+        if (entry.busId == busId) return static_cast<Producer*>(entry.producer);
+    }
+
+    // Not cached: this thread's slot if it already has one (the cache only
+    // remembers the last few buses), otherwise claim a new one
+    const std::thread::id self = std::this_thread::get_id();
+    Producer* producer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(producerMutex);
+        const uint32_t claimed = producerCount.load();
+        for (uint32_t p = 0; p < claimed; ++p) {
+            if (producers[p]->owner == self) {
+                producer = producers[p].get();
+                break;
+            }
+        }
+        if (!producer && claimed < MAX_PRODUCERS) {
+            producers[claimed] = std::make_unique<Producer>();
+            producers[claimed]->owner = self;
+            producer = producers[claimed].get();
+            producerCount.store(claimed + 1);
+        }
+    }
+    cache[nextEntry++ % PRODUCER_CACHE_SIZE] = {busId, producer};
+    return producer;
+}
+
+void EventBus::dispatch() {
+    drainList.clear();
+    const uint32_t claimed = producerCount.load();
+    for (uint32_t p = 0; p < claimed; ++p) {
+        drainList.push_back(producers[p].get());
+    }
+    drainList.push_back(&overflow);
+
+    // Count everything, and drop the types nobody listens to
+    for (Producer* producer : drainList) {
+        for (uint32_t id = 0; id < MAX_EVENT_TYPES; ++id) {
+            BufferBase* buffer = producer->buffers[id].get();
+            if (!buffer) continue;
+
+            publishedCount += buffer->size();
+            if (!channels[id]) {
+                buffer->clear();
+            }
+        }
+    }
+
+    // Take every batch before calling anyone, so events published by the
+    // handlers wait for the next dispatch whatever their type
+    for (uint32_t id : channelOrder) {
+        channels[id]->drain(drainList.data(), drainList.size());
+    }
+    for (uint32_t id : channelOrder) {
+        dispatchedCount += channels[id]->deliver();
+    }
+}
+
+void EventBus::clear() {
+    const uint32_t claimed = producerCount.load();
+    for (uint32_t p = 0; p < claimed; ++p) {
+        for (auto& buffer : producers[p]->buffers) {
+            if (buffer) buffer->clear();
+        }
+    }
+    for (auto& buffer : overflow.buffers) {
+        if (buffer) buffer->clear();
+    }
+}
+
+EventBus::Stats EventBus::getStats() const {
+    Stats stats;
+    stats.published = publishedCount;
+    stats.dispatched = dispatchedCount;
+    stats.producers = producerCount.load();
+    return stats;
+}
+
+void EventBus::resetStats() {
+    publishedCount = 0;
+    dispatchedCount = 0;
+}
@@ -0,0 +1,232 @@
+#include "flow_field.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const float UNREACHED = std::numeric_limits<float>::max();
+const uint32_t UNREACHED_COST = std::numeric_limits<uint32_t>::max();
+
+// 8-connected neighborhood with integer octile step costs (10 per cell, 14 diagonal)
+const int32_t NEIGHBOR_X[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+const int32_t NEIGHBOR_Z[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+const uint32_t NEIGHBOR_COST[8] = {10, 10, 10, 10, 14, 14, 14, 14};
+const uint32_t COST_PER_CELL = 10;
+
+// A ring of this many buckets covers every cost still open (Dial's algorithm)
+const uint32_t BUCKET_COUNT = 15;
+
+int32_t floorToMultiple(int32_t value, int32_t step) {
+    int32_t q = value / step;
+    if (value % step != 0 && value < 0) q--;
+    return q * step;
+}
+
+} // namespace
+
+FlowField::FlowField(float cellSize, int32_t gridSize)
+    : cellSize(cellSize)
+    , inverseCellSize(1.0f / cellSize)
+    , gridSize(gridSize)
+    , originX(0)
+    , originZ(0)
+    , rebuildCount(0)
+{
+}
+
+int32_t FlowField::cellCoord(float value) const {
+    return static_cast<int32_t>(std::floor(value * inverseCellSize));
+}
+
+int32_t FlowField::gridIndex(int32_t cellX, int32_t cellZ) const {
+    int32_t x = cellX - originX;
+    int32_t z = cellZ - originZ;
+    if (x < 0 || z < 0 || x >= gridSize || z >= gridSize) return -1;
+    return z * gridSize + x;
+}
+
+void FlowField::clear() {
+    goals.clear();
+    goalCells.clear();
+    distances.clear();
+    directions.clear();
+    nearestGoal.clear();
+}
+
+bool FlowField::update(const std::vector<Goal>& newGoals) {
+    // Cell indices only fit 8 bits of goal index
+    size_t goalCount = std::min<size_t>(newGoals.size(), NO_GOAL);
+
+    if (goalCount == 0) {
+        bool hadField = !distances.empty();
+        clear();
+        return hadField;
+    }
+
+    // Keep the goals' centroid near the middle of the grid
+    glm::vec3 centroid(0.0f);
+    for (size_t i = 0; i < goalCount; ++i) {
+        centroid += newGoals[i].position;
+    }
+    centroid /= static_cast<float>(goalCount);
+
+    int32_t newOriginX = floorToMultiple(cellCoord(centroid.x) - gridSize / 2, RECENTER_STEP);
+    int32_t newOriginZ = floorToMultiple(cellCoord(centroid.z) - gridSize / 2, RECENTER_STEP);
+    bool moved = distances.empty() || newOriginX != originX || newOriginZ != originZ;
+    originX = newOriginX;
+    originZ = newOriginZ;
+
+    goals.assign(newGoals.begin(), newGoals.begin() + goalCount);
+
+    bool changed = moved || goalCells.size() != goalCount;
+    goalCells.resize(goalCount);
+    for (size_t i = 0; i < goalCount; ++i) {
+        int32_t cell = gridIndex(cellCoord(goals[i].position.x), cellCoord(goals[i].position.z));
+        if (cell != goalCells[i]) {
+            goalCells[i] = cell;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        rebuild();
+    }
+    return changed;
+}
+
+void FlowField::rebuild() {
+    const size_t cellCount = static_cast<size_t>(gridSize) * gridSize;
+    distances.assign(cellCount, UNREACHED);
+    directions.assign(cellCount, glm::vec2(0.0f));
+    nearestGoal.assign(cellCount, NO_GOAL);
+
+    // Multi-source Dijkstra over a bucket queue; with small integer step costs
+    // each cell is settled in O(1). The first goal claims a cell shared by several.
+    costs.assign(cellCount, UNREACHED_COST);
+    buckets.resize(BUCKET_COUNT);
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+
+    size_t openCount = 0;
+    for (size_t i = 0; i < goalCells.size(); ++i) {
+        int32_t cell = goalCells[i];
+        if (cell < 0 || nearestGoal[cell] != NO_GOAL) continue;
+
+        costs[cell] = 0;
+        nearestGoal[cell] = static_cast<uint8_t>(i);
+        buckets[0].push_back(cell);
+        openCount++;
+    }
+
+    for (uint32_t cost = 0; openCount > 0; ++cost) {
+        // Step costs are at least 10, so nothing is added to the bucket being drained
+        std::vector<int32_t>& bucket = buckets[cost % BUCKET_COUNT];
+        for (int32_t cell : bucket) {
+            openCount--;
+
+            // Stale entry left behind by a later improvement
+            if (costs[cell] != cost) continue;
+
+            int32_t x = cell % gridSize;
+            int32_t z = cell / gridSize;
+            for (int n = 0; n < 8; ++n) {
+                int32_t nx = x + NEIGHBOR_X[n];
+                int32_t nz = z + NEIGHBOR_Z[n];
+                if (nx < 0 || nz < 0 || nx >= gridSize || nz >= gridSize) continue;
+
+                int32_t neighbor = nz * gridSize + nx;
+                uint32_t candidate = cost + NEIGHBOR_COST[n];
+                if (candidate < costs[neighbor]) {
+                    costs[neighbor] = candidate;
+                    nearestGoal[neighbor] = nearestGoal[cell];
+                    buckets[candidate % BUCKET_COUNT].push_back(neighbor);
+                    openCount++;
+                }
+            }
+        }
+        bucket.clear();
+    }
+
+    const float costToWorld = cellSize / static_cast<float>(COST_PER_CELL);
+    for (size_t cell = 0; cell < cellCount; ++cell) {
+        if (costs[cell] != UNREACHED_COST) {
+            distances[cell] = static_cast<float>(costs[cell]) * costToWorld;
+        }
+    }
+
+    // Each cell points down the distance gradient (central differences). Picking
+    // the lowest neighbor instead would snap directions to 45 degree steps.
+    auto distanceAt = [&](int32_t x, int32_t z, float fallback) {
+        if (x < 0 || z < 0 || x >= gridSize || z >= gridSize) return fallback;
+        float distance = distances[z * gridSize + x];
+        return distance == UNREACHED ? fallback : distance;
+    };
+    for (int32_t z = 0; z < gridSize; ++z) {
+        for (int32_t x = 0; x < gridSize; ++x) {
+            int32_t cell = z * gridSize + x;
+            float center = distances[cell];
+            if (center == 0.0f || center == UNREACHED) continue;
+
+            glm::vec2 gradient(distanceAt(x + 1, z, center) - distanceAt(x - 1, z, center),
+                               distanceAt(x, z + 1, center) - distanceAt(x, z - 1, center));
+            float length = glm::length(gradient);
+            if (length > 0.0001f) {
+                directions[cell] = -gradient / length;
+            }
+        }
+    }
+
+    rebuildCount++;
+}
+
+bool FlowField::sample(const glm::vec3& position, Sample& result) const {
+    if (distances.empty()) return false;
+
+    int32_t cell = gridIndex(cellCoord(position.x), cellCoord(position.z));
+    if (cell < 0 || nearestGoal[cell] == NO_GOAL) return false;
+
+    // Blend the four cell centers around position so directions turn smoothly
+    float fx = position.x * inverseCellSize - 0.5f;
+    float fz = position.z * inverseCellSize - 0.5f;
+    int32_t baseX = static_cast<int32_t>(std::floor(fx));
+    int32_t baseZ = static_cast<int32_t>(std::floor(fz));
+    float tx = fx - static_cast<float>(baseX);
+    float tz = fz - static_cast<float>(baseZ);
+
+    glm::vec2 direction(0.0f);
+    float distance = 0.0f;
+    float totalWeight = 0.0f;
+    for (int corner = 0; corner < 4; ++corner) {
+        int32_t dx = corner & 1;
+        int32_t dz = corner >> 1;
+        int32_t neighbor = gridIndex(baseX + dx, baseZ + dz);
+        if (neighbor < 0 || nearestGoal[neighbor] == NO_GOAL) continue;
+
+        float weight = (dx ? tx : 1.0f - tx) * (dz ? tz : 1.0f - tz);
+        direction += directions[neighbor] * weight;
+        distance += distances[neighbor] * weight;
+        totalWeight += weight;
+    }
+
+    if (totalWeight <= 0.0f) {
+        direction = directions[cell];
+        distance = distances[cell];
+    } else {
+        distance /= totalWeight;
+    }
+
+    // Opposing directions can cancel out where two goals' regions meet
+    float length = glm::length(direction);
+    if (length > 0.001f) {
+        direction /= length;
+    } else {
+        direction = directions[cell];
+    }
+
+    result.direction = glm::vec3(direction.x, 0.0f, direction.y);
+    result.distance = distance;
+    result.goal = nearestGoal[cell];
+    return true;
+}
@@ -6,6 +6,7 @@
 Game::Game()
     : running(false)
     , lastFrameTime(0.0)
+    , simAccumulator(0.0)
     , lastWindowWidth(0)
     , lastWindowHeight(0)
     , activePlayerIndex(0)
@@ -33,30 +34,21 @@ bool Game::initialize() {
     // Create input manager
     inputManager = std::make_unique<InputManager>(renderer->getWindow());
 
-    // Create entity manager
-    entityManager = std::make_unique<EntityManager>();
-
-    // Create party with 3 player characters
-    // Character 1 - Red
-    auto player1 = std::make_shared<PlayerEntity>();
-    player1->position = glm::vec3(0.0f, 0.0f, 0.0f);
-    player1->color = glm::vec3(0.9f, 0.2f, 0.2f); // Red
-    party.push_back(player1);
-    entityManager->addEntity(player1);
-
-    // Character 2 - Green
-    auto player2 = std::make_shared<PlayerEntity>();
-    player2->position = glm::vec3(2.0f, 0.0f, 0.0f);
-    player2->color = glm::vec3(0.2f, 0.9f, 0.2f); // Green
-    party.push_back(player2);
-    entityManager->addEntity(player2);
-
-    // Character 3 - Blue
-    auto player3 = std::make_shared<PlayerEntity>();
-    player3->position = glm::vec3(-2.0f, 0.0f, 0.0f);
-    player3->color = glm::vec3(0.2f, 0.2f, 0.9f); // Blue
-    party.push_back(player3);
-    entityManager->addEntity(player3);
+    // Create the simulation and its starting party. The seed is the only
+    // source of randomness, so it is all a recording needs besides inputs.
+    std::random_device rd;
+    uint64_t seed = static_cast<uint64_t>(rd()) << 32 | rd();
+    simulation = std::make_unique<Simulation>(UpdateMode::Parallel, 0, seed);
+    simulation->createParty();
+
+    if (!recordPath.empty()) {
+        recorder = std::make_unique<InputRecorder>();
+        if (!recorder->open(recordPath, seed, simulation->getEntityManager().getUpdateMode())) {
+            return false;
+        }
+        simulation->setRecorder(recorder.get());
+        std::cout << "Recording inputs to " << recordPath << std::endl;
+    }
 
     // Start with the first character active
     activePlayerIndex = 0;
@@ -77,7 +69,7 @@ bool Game::initialize() {
     running = true;
 
     std::cout << "Game initialized successfully" << std::endl;
-    std::cout << "Party size: " << party.size() << " characters" << std::endl;
+    std::cout << "Party size: " << simulation->getParty().size() << " characters" << std::endl;
     std::cout << "Controls:" << std::endl;
     std::cout << "  Right-click and hold to move the active character" << std::endl;
     std::cout << "  Tab to switch between party members" << std::endl;
@@ -88,22 +80,40 @@ bool Game::initialize() {
 
 void Game::run() {
     while (running && !renderer->shouldClose()) {
-        // Calculate delta time
+        // Calculate frame time
         double currentTime = glfwGetTime();
-        float deltaTime = static_cast<float>(currentTime - lastFrameTime);
+        double frameTime = currentTime - lastFrameTime;
         lastFrameTime = currentTime;
 
-        // Update
         handleInput();
-        update(deltaTime);
 
-        // Render
-        render();
+        // Advance the simulation in fixed steps
+        simAccumulator += frameTime;
+        int steps = 0;
+        while (simAccumulator >= Simulation::TIMESTEP && steps < MAX_SIM_STEPS_PER_FRAME) {
+            update(static_cast<float>(Simulation::TIMESTEP));
+            simAccumulator -= Simulation::TIMESTEP;
+            steps++;
+        }
+
+        // After a spike, let the simulation fall behind rather than spiral
+        if (simAccumulator >= Simulation::TIMESTEP) {
+            simAccumulator = 0.0;
+        }
+
+        // Render between the last two simulation states
+        float alpha = static_cast<float>(simAccumulator / Simulation::TIMESTEP);
+        updateCamera(static_cast<float>(frameTime), alpha);
+        render(alpha);
     }
 }
 
 void Game::shutdown() {
-    entityManager.reset();
+    if (recorder && simulation) {
+        recorder->close(simulation->getTickCount());
+    }
+    recorder.reset();
+    simulation.reset();
     inputManager.reset();
     renderer.reset();
 }
@@ -111,6 +121,8 @@ void Game::shutdown() {
 void Game::handleInput() {
     inputManager->update();
 
+    const auto& party = simulation->getParty();
+
     // Tab key to switch between party members
     if (inputManager->isTabPressed()) {
         size_t newIndex = (activePlayerIndex + 1) % party.size();
@@ -120,47 +132,33 @@ void Game::handleInput() {
     }
 
     // Q key to spawn a BasicShooterEnemy at a random position
+    // (the position comes from the simulation's seeded RNG)
     if (inputManager->isQPressed()) {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_real_distribution<float> dis(-15.0f, 15.0f);
-
-        auto enemy = std::make_shared<BasicShooterEnemy>();
-        enemy->position = glm::vec3(dis(gen), 0.0f, dis(gen));
-        enemy->color = glm::vec3(0.9f, 0.5f, 0.1f); // Orange color for enemies
-        enemy->party = &party; // Set party reference for AI
-        enemy->movementSpeed = 3.0f; // Slower than default player speed
-
-        entityManager->addEntity(enemy);
-
-        std::cout << "Spawned BasicShooterEnemy at position ("
-                  << enemy->position.x << ", " << enemy->position.y << ", " << enemy->position.z << ")"
-                  << std::endl;
+        simulation->queueCommand(SimCommand::spawnEnemy());
+        std::cout << "Spawning BasicShooterEnemy" << std::endl;
     }
 
-    // Get the active player
-    auto activePlayer = party[activePlayerIndex];
-
     // Right mouse button hold to move
     if (inputManager->isRightMouseButtonDown()) {
         glm::vec2 mousePos = inputManager->getMousePosition();
         glm::vec3 worldPos = inputManager->screenToWorld(mousePos, viewMatrix, projectionMatrix);
 
         // Move active player to cursor position
-        if (activePlayer) {
-            activePlayer->moveTo(worldPos);
-        }
+        simulation->queueCommand(SimCommand::moveTo(activePlayerIndex, worldPos));
     }
 
     // Stop moving when right mouse button is released
     if (inputManager->isRightMouseButtonReleased()) {
-        if (activePlayer) {
-            activePlayer->stop();
-        }
+        simulation->queueCommand(SimCommand::stop(activePlayerIndex));
     }
 }
 
 void Game::update(float deltaTime) {
+    // Update all entities
+    simulation->step(deltaTime);
+}
+
+void Game::updateCamera(float frameTime, float alpha) {
     // Check for window resize and update projection matrix if needed
     int currentWidth = renderer->getWindowWidth();
     int currentHeight = renderer->getWindowHeight();
@@ -171,16 +169,15 @@ void Game::update(float deltaTime) {
         std::cout << "Window resized, updated projection matrix" << std::endl;
     }
 
-    // Update all entities
-    entityManager->updateAll(deltaTime);
+    const auto& party = simulation->getParty();
 
-    // Update camera
+    // Update camera (follows the interpolated position that gets drawn)
     if (cameraTransitioning) {
-        updateCameraTransition(deltaTime);
+        updateCameraTransition(frameTime, alpha);
     } else if (!party.empty() && activePlayerIndex < party.size()) {
         // Normal following behavior when not transitioning
         auto activePlayer = party[activePlayerIndex];
-        cameraPosition = activePlayer->position + cameraOffset;
+        cameraPosition = activePlayer->getInterpolatedPosition(alpha) + cameraOffset;
         cameraVelocity = glm::vec3(0.0f);
     }
 
@@ -191,14 +188,14 @@ void Game::update(float deltaTime) {
     renderer->setViewMatrix(viewMatrix);
 }
 
-void Game::render() {
+void Game::render(float alpha) {
     renderer->beginFrame();
 
     // Render grid
     renderer->renderGrid(1.0f, 40, glm::vec3(0.3f, 0.3f, 0.35f));
 
     // Render entities
-    renderer->renderEntities(*entityManager);
+    renderer->renderEntities(simulation->getEntityManager(), alpha);
 
     renderer->endFrame();
 }
@@ -218,7 +215,7 @@ void Game::updateProjectionMatrix() {
 }
 
 void Game::startCameraTransition(size_t targetIndex) {
-    if (targetIndex >= party.size()) {
+    if (targetIndex >= simulation->getParty().size()) {
         return;
     }
 
@@ -229,13 +226,13 @@ void Game::startCameraTransition(size_t targetIndex) {
     std::cout << "Starting camera transition to character " << (targetIndex + 1) << std::endl;
 }
 
-void Game::updateCameraTransition(float deltaTime) {
+void Game::updateCameraTransition(float deltaTime, float alpha) {
     transitionTimer += deltaTime;
     float remainingTime = CAMERA_TRANSITION_DURATION - transitionTimer;
 
     // Get target camera position (where we want to be)
-    auto targetPlayer = party[transitionTargetIndex];
-    glm::vec3 targetCameraPos = targetPlayer->position + cameraOffset;
+    auto targetPlayer = simulation->getParty()[transitionTargetIndex];
+    glm::vec3 targetCameraPos = targetPlayer->getInterpolatedPosition(alpha) + cameraOffset;
 
     if (remainingTime <= 0.0f) {
         // Transition complete - snap to exact target position to avoid overshoot
@@ -0,0 +1,210 @@
+#include "input_record.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+const char MAGIC[4] = {'A', 'R', 'P', 'I'};
+const uint8_t END_MARKER = 0xFF;
+
+void writeU8(FILE* file, uint8_t value) {
+    fputc(value, file);
+}
+
+void writeU32(FILE* file, uint32_t value) {
+    uint8_t bytes[4];
+    for (int i = 0; i < 4; ++i) bytes[i] = static_cast<uint8_t>(value >> (i * 8));
+    fwrite(bytes, 1, 4, file);
+}
+
+void writeU64(FILE* file, uint64_t value) {
+    writeU32(file, static_cast<uint32_t>(value));
+    writeU32(file, static_cast<uint32_t>(value >> 32));
+}
+
+void writeF32(FILE* file, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeU32(file, bits);
+}
+
+bool readU8(FILE* file, uint8_t& value) {
+    int c = fgetc(file);
+    if (c == EOF) return false;
+    value = static_cast<uint8_t>(c);
+    return true;
+}
+
+bool readU32(FILE* file, uint32_t& value) {
+    uint8_t bytes[4];
+    if (fread(bytes, 1, 4, file) != 4) return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(bytes[i]) << (i * 8);
+    return true;
+}
+
+bool readU64(FILE* file, uint64_t& value) {
+    uint32_t low, high;
+    if (!readU32(file, low) || !readU32(file, high)) return false;
+    value = static_cast<uint64_t>(high) << 32 | low;
+    return true;
+}
+
+bool readF32(FILE* file, float& value) {
+    uint32_t bits;
+    if (!readU32(file, bits)) return false;
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+} // namespace
+
+InputRecorder::InputRecorder()
+    : file(nullptr)
+{
+}
+
+InputRecorder::~InputRecorder() {
+    // Without an explicit close the end marker is missing and replays stop at the last command
+    if (file) {
+        fclose(file);
+    }
+}
+
+bool InputRecorder::open(const std::string& path, uint64_t seed, UpdateMode mode) {
+    if (file) {
+        fclose(file);
+    }
+
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Failed to open recording file: " << path << std::endl;
+        return false;
+    }
+
+    fwrite(MAGIC, 1, 4, file);
+    writeU32(file, InputReplay::VERSION);
+    writeU64(file, seed);
+    writeU8(file, static_cast<uint8_t>(mode));
+    writeU8(file, 0);
+    writeU8(file, 0);
+    writeU8(file, 0);
+    return true;
+}
+
+void InputRecorder::record(uint64_t tick, const std::vector<SimCommand>& commands) {
+    if (!file) return;
+
+    for (const SimCommand& command : commands) {
+        writeU32(file, static_cast<uint32_t>(tick));
+        writeU8(file, static_cast<uint8_t>(command.type));
+
+        switch (command.type) {
+            case SimCommand::Type::MoveTo:
+                writeU8(file, command.partyIndex);
+                writeF32(file, command.target.x);
+                writeF32(file, command.target.y);
+                writeF32(file, command.target.z);
+                break;
+            case SimCommand::Type::Stop:
+                writeU8(file, command.partyIndex);
+                break;
+            case SimCommand::Type::SpawnEnemy:
+                break;
+        }
+    }
+}
+
+void InputRecorder::close(uint64_t tickCount) {
+    if (!file) return;
+
+    writeU32(file, static_cast<uint32_t>(tickCount));
+    writeU8(file, END_MARKER);
+    fclose(file);
+    file = nullptr;
+}
+
+bool InputReplay::load(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "Failed to open recording file: " << path << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version;
+    uint8_t mode, padding[3];
+    if (fread(magic, 1, 4, file) != 4 || std::memcmp(magic, MAGIC, 4) != 0 ||
+        !readU32(file, version) || !readU64(file, seed) || !readU8(file, mode) ||
+        fread(padding, 1, 3, file) != 3) {
+        std::cerr << "Invalid recording file: " << path << std::endl;
+        fclose(file);
+        return false;
+    }
+
+    if (version != VERSION) {
+        std::cerr << "Unsupported recording version " << version << " (expected " << VERSION << ")" << std::endl;
+        fclose(file);
+        return false;
+    }
+
+    updateMode = mode == static_cast<uint8_t>(UpdateMode::Sequential) ? UpdateMode::Sequential : UpdateMode::Parallel;
+    commands.clear();
+    tickCount = 0;
+
+    bool ended = false;
+    while (!ended) {
+        uint32_t tick;
+        uint8_t type;
+        if (!readU32(file, tick) || !readU8(file, type)) break;
+
+        TickCommand entry{tick, SimCommand()};
+        bool valid = true;
+        switch (type) {
+            case static_cast<uint8_t>(SimCommand::Type::MoveTo):
+                entry.command.type = SimCommand::Type::MoveTo;
+                valid = readU8(file, entry.command.partyIndex) && readF32(file, entry.command.target.x) &&
+                        readF32(file, entry.command.target.y) && readF32(file, entry.command.target.z);
+                break;
+            case static_cast<uint8_t>(SimCommand::Type::Stop):
+                entry.command.type = SimCommand::Type::Stop;
+                valid = readU8(file, entry.command.partyIndex);
+                break;
+            case static_cast<uint8_t>(SimCommand::Type::SpawnEnemy):
+                entry.command.type = SimCommand::Type::SpawnEnemy;
+                break;
+            case END_MARKER:
+                tickCount = tick;
+                ended = true;
+                continue;
+            default:
+                valid = false;
+                break;
+        }
+
+        if (!valid) {
+            std::cerr << "Corrupt record at tick " << tick << " in " << path << std::endl;
+            fclose(file);
+            return false;
+        }
+        commands.push_back(entry);
+    }
+    fclose(file);
+
+    // A recording cut off before close() still replays up to its last command
+    if (!ended && !commands.empty()) {
+        tickCount = commands.back().tick + 1;
+        std::cerr << "Recording has no end marker; replaying " << tickCount << " ticks" << std::endl;
+    }
+    return true;
+}
+
+void InputReplay::commandsForTick(uint64_t tick, std::vector<SimCommand>& results) const {
+    auto it = std::lower_bound(commands.begin(), commands.end(), tick, [](const TickCommand& entry, uint64_t value) {
+        return entry.tick < value;
+    });
+    for (; it != commands.end() && it->tick == tick; ++it) {
+        results.push_back(it->command);
+    }
+}
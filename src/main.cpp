@@ -1,11 +1,19 @@
 #include "game.h"
+#include <cstring>
 #include <iostream>
 #include <exception>
 
-int main() {
+int main(int argc, char** argv) {
     try {
         Game game;
 
+        // --record <file> logs every input so the session can be replayed with sim_replay
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+                game.setRecordPath(argv[++i]);
+            }
+        }
+
         if (!game.initialize()) {
             std::cerr << "Failed to initialize game" << std::endl;
             return 1;
@@ -0,0 +1,134 @@
+#include "mob_collision.h"
+#include "separation_kernel.h"
+
+glm::vec3 sweepMobToFirstContact(const SpatialHashGrid& grid, const std::vector<float>& radii, uint32_t slot,
+                                 const glm::vec3& start, const glm::vec3& desiredPosition,
+                                 std::vector<MobContact>* contacts) {
+    const float radius = radii[slot];
+    const float contactSkin = 0.001f; // Gap left at contact so the next sweep starts outside
+    const float slideFactor = 0.7f;   // Same friction as resolveMobCollisions
+
+    // One sweep for the step and one for the slide along whatever it hit
+    glm::vec3 from = start;
+    glm::vec3 to = desiredPosition;
+    for (int sweep = 0; sweep < 2; ++sweep) {
+        SpatialHashGrid::SweepHit hit;
+        if (!grid.sweepCircle(from, to, radius, slot, hit)) {
+            return to;
+        }
+
+        glm::vec3 movement = to - from;
+        float length = glm::length(movement);
+        float time = length > 0.0f ? glm::max(0.0f, hit.time - contactSkin / length) : 0.0f;
+        glm::vec3 contact = from + movement * time;
+        if (contacts) {
+            contacts->push_back({hit.slot, contact});
+        }
+
+        // Keep the tangential part of the rest of the step
+        glm::vec3 remaining = movement * (1.0f - time);
+        glm::vec3 slide = remaining - hit.normal * glm::dot(remaining, hit.normal);
+
+        from = contact;
+        to = contact + slide * slideFactor;
+    }
+
+    // Blocked again while sliding: stay at the last contact
+    return from;
+}
+
+glm::vec3 resolveMobCollisions(const SpatialHashGrid& grid, const std::vector<glm::vec3>& positions,
+                               const std::vector<float>& radii, uint32_t slot, const glm::vec3& desiredPosition,
+                               std::vector<MobContact>* contacts) {
+    const float radius = radii[slot];
+
+    glm::vec3 movement = desiredPosition - positions[slot];
+    glm::vec3 finalPosition = desiredPosition;
+
+    // Collect all overlapping bodies from the broadphase
+    thread_local std::vector<uint32_t> neighbors;
+    thread_local std::vector<uint32_t> collisions;
+    collisions.clear();
+    grid.queryRadius(desiredPosition, radius + grid.getMaxRadius(), neighbors);
+
+    for (uint32_t other : neighbors) {
+        if (other == slot) continue;
+
+        float distance = glm::length(positions[other] - desiredPosition);
+        if (distance < radius + radii[other]) {
+            collisions.push_back(other);
+        }
+    }
+
+    // Process collisions with sliding
+    for (uint32_t other : collisions) {
+        const glm::vec3& otherPosition = positions[other];
+        glm::vec3 toOther = otherPosition - finalPosition;
+        float currentDist = glm::length(toOther);
+        float minDistance = radius + radii[other];
+
+        if (currentDist < minDistance && currentDist > 0.001f) {
+            // Instead of stopping, slide along the collision surface
+            // Project movement onto the plane tangent to collision
+            glm::vec3 collisionNormal = -toOther / currentDist;
+            glm::vec3 slideDirection = movement - collisionNormal * glm::dot(movement, collisionNormal);
+
+            // Apply sliding with some friction
+            float slideFactor = 0.7f; // Friction coefficient (0 = full stop, 1 = perfect slide)
+            finalPosition = positions[slot] + slideDirection * slideFactor;
+
+            // Ensure we're not still penetrating after slide
+            glm::vec3 afterSlideToOther = otherPosition - finalPosition;
+            float afterSlideDist = glm::length(afterSlideToOther);
+            if (afterSlideDist < minDistance && afterSlideDist > 0.001f) {
+                // Push out to minimum distance
+                finalPosition = otherPosition - glm::normalize(afterSlideToOther) * minDistance;
+            }
+        }
+    }
+
+    if (contacts) {
+        for (uint32_t other : collisions) {
+            contacts->push_back({other, finalPosition});
+        }
+    }
+    return finalPosition;
+}
+
+glm::vec3 applyMobSeparation(const SpatialHashGrid& grid, const std::vector<glm::vec3>& positions,
+                             const std::vector<float>& radii, uint32_t slot, const glm::vec3& position,
+                             float deltaTime) {
+    const float radius = radii[slot];
+
+    // Nobody can be closer than the largest preferred distance
+    thread_local std::vector<uint32_t> neighbors;
+    grid.queryRadius(position, (radius + grid.getMaxRadius()) * 1.2f, neighbors);
+
+    // Pack neighbor coordinates into contiguous lanes for the SIMD kernel
+    thread_local std::vector<float> xs, ys, zs, neighborRadii;
+    xs.clear();
+    ys.clear();
+    zs.clear();
+    neighborRadii.clear();
+    for (uint32_t other : neighbors) {
+        if (other == slot) continue;
+
+        const glm::vec3& otherPosition = positions[other];
+        xs.push_back(otherPosition.x);
+        ys.push_back(otherPosition.y);
+        zs.push_back(otherPosition.z);
+        neighborRadii.push_back(radii[other]);
+    }
+
+    static const SeparationKernel separationKernel = getSeparationKernel();
+    SeparationResult separation = separationKernel(position, radius, xs.data(), ys.data(), zs.data(),
+                                                   neighborRadii.data(), xs.size());
+
+    // Apply the averaged separation force
+    if (separation.count > 0) {
+        glm::vec3 separationForce = separation.force / static_cast<float>(separation.count);
+        float separationSpeed = 2.0f; // Gentle push speed
+        return position + separationForce * separationSpeed * deltaTime;
+    }
+    return position;
+}
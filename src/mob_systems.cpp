@@ -0,0 +1,83 @@
+#include "mob_systems.h"
+#include "mob_collision.h"
+
+MobMovementSystem::MobMovementSystem(CollisionMode collisionMode)
+    : collisionMode(collisionMode)
+{
+}
+
+void MobMovementSystem::update(ArchetypeWorld& world, float deltaTime, const NavGrid* navGrid, ThreadPool* pool) {
+    // Freeze where every body is, in query order, and bucket them
+    const size_t count = world.count<PositionComponent, BodyComponent, MotionComponent>();
+    frozen.positions.resize(count);
+    frozen.radii.resize(count);
+    frozen.kinds.resize(count);
+    frozen.active.assign(count, 1);
+    frozen.stillTicks.assign(count, 0);
+    world.forEachChunk<const PositionComponent, const BodyComponent, const MotionComponent>(
+        [&](size_t first, size_t chunkCount, const EntityHandle*, const PositionComponent* positions,
+            const BodyComponent* bodies, const MotionComponent*) {
+            for (size_t i = 0; i < chunkCount; ++i) {
+                frozen.positions[first + i] = positions[i].value;
+                frozen.radii[first + i] = bodies[i].radius;
+                frozen.kinds[first + i] = bodies[i].kind;
+            }
+        });
+    grid.rebuild(frozen);
+
+    auto stepChunk = [&](size_t first, size_t chunkCount, const EntityHandle*, PositionComponent* positions,
+                         const BodyComponent*, MotionComponent* motions) {
+        for (size_t i = 0; i < chunkCount; ++i) {
+            positions[i].value = stepMob(static_cast<uint32_t>(first + i), motions[i], deltaTime, navGrid);
+        }
+    };
+    if (pool) {
+        world.parallelForEachChunk<PositionComponent, const BodyComponent, MotionComponent>(*pool, stepChunk);
+    } else {
+        world.forEachChunk<PositionComponent, const BodyComponent, MotionComponent>(stepChunk);
+    }
+}
+
+glm::vec3 MobMovementSystem::stepMob(uint32_t row, MotionComponent& motion, float deltaTime,
+                                     const NavGrid* navGrid) const {
+    const glm::vec3 start = frozen.positions[row];
+    glm::vec3 position = start;
+
+    if (motion.moving) {
+        glm::vec3 direction = motion.target - position;
+        float distance = glm::length(direction);
+
+        if (distance > 0.1f) {
+            direction = glm::normalize(direction);
+            float moveDistance = motion.speed * deltaTime;
+
+            glm::vec3 desiredPosition;
+            if (moveDistance >= distance) {
+                desiredPosition = motion.target;
+                motion.moving = 0;
+            } else {
+                desiredPosition = position + direction * moveDistance;
+            }
+
+            if (collisionMode == CollisionMode::Continuous) {
+                desiredPosition = sweepMobToFirstContact(grid, frozen.radii, row, position, desiredPosition);
+            }
+            position = resolveMobCollisions(grid, frozen.positions, frozen.radii, row, desiredPosition);
+
+            if (glm::length(motion.target - position) < 0.1f) {
+                position = motion.target;
+                motion.moving = 0;
+            }
+        } else {
+            position = motion.target;
+            motion.moving = 0;
+        }
+    }
+
+    position = applyMobSeparation(grid, frozen.positions, frozen.radii, row, position, deltaTime);
+
+    if (navGrid) {
+        position = navGrid->slideToWalkable(start, position);
+    }
+    return position;
+}
@@ -0,0 +1,158 @@
+#include "nav_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+NavGrid::NavGrid(float cellSize, int32_t width, int32_t height)
+    : cellSize(cellSize)
+    , inverseCellSize(1.0f / cellSize)
+    , width(width)
+    , height(height)
+    , originX(-width / 2)
+    , originZ(-height / 2)
+    , blocked(static_cast<size_t>(width) * height, 0)
+    , blockedCount(0)
+{
+}
+
+int32_t NavGrid::cellIndex(int32_t x, int32_t z) const {
+    if (x < 0 || z < 0 || x >= width || z >= height) return -1;
+    return z * width + x;
+}
+
+int32_t NavGrid::cellIndex(const glm::vec3& position) const {
+    int32_t x = static_cast<int32_t>(std::floor(position.x * inverseCellSize)) - originX;
+    int32_t z = static_cast<int32_t>(std::floor(position.z * inverseCellSize)) - originZ;
+    return cellIndex(x, z);
+}
+
+glm::vec3 NavGrid::cellCenter(int32_t index) const {
+    return glm::vec3((cellX(index) + originX + 0.5f) * cellSize, 0.0f, (cellZ(index) + originZ + 0.5f) * cellSize);
+}
+
+void NavGrid::setBlocked(int32_t index, bool value) {
+    if (index < 0 || index >= getCellCount() || (blocked[index] != 0) == value) return;
+
+    blocked[index] = value ? 1 : 0;
+    if (value) {
+        blockedCount++;
+    } else {
+        blockedCount--;
+    }
+    changedCells.push_back(index);
+}
+
+void NavGrid::setBlocked(const glm::vec3& position, bool value) {
+    setBlocked(cellIndex(position), value);
+}
+
+void NavGrid::setBlockedRect(const glm::vec3& corner, const glm::vec3& oppositeCorner, bool value) {
+    glm::vec3 low = glm::min(corner, oppositeCorner);
+    glm::vec3 high = glm::max(corner, oppositeCorner);
+    int32_t minX = std::max(0, static_cast<int32_t>(std::floor(low.x * inverseCellSize)) - originX);
+    int32_t minZ = std::max(0, static_cast<int32_t>(std::floor(low.z * inverseCellSize)) - originZ);
+    int32_t maxX = std::min(width - 1, static_cast<int32_t>(std::floor(high.x * inverseCellSize)) - originX);
+    int32_t maxZ = std::min(height - 1, static_cast<int32_t>(std::floor(high.z * inverseCellSize)) - originZ);
+
+    for (int32_t z = minZ; z <= maxZ; ++z) {
+        for (int32_t x = minX; x <= maxX; ++x) {
+            setBlocked(z * width + x, value);
+        }
+    }
+}
+
+void NavGrid::clearBlocked() {
+    for (int32_t index = 0; index < getCellCount(); ++index) {
+        setBlocked(index, false);
+    }
+}
+
+bool NavGrid::isWalkable(const glm::vec3& position) const {
+    int32_t index = cellIndex(position);
+    return index < 0 || !blocked[index];
+}
+
+glm::vec3 NavGrid::slideToWalkable(const glm::vec3& from, const glm::vec3& to) const {
+    // A mob caught inside a cell that was just blocked may walk out freely
+    if (blockedCount == 0 || isWalkable(to) || !isWalkable(from)) return to;
+
+    glm::vec3 alongX(to.x, to.y, from.z);
+    if (isWalkable(alongX)) return alongX;
+
+    glm::vec3 alongZ(from.x, to.y, to.z);
+    if (isWalkable(alongZ)) return alongZ;
+
+    return from;
+}
+
+template <typename Visit>
+bool NavGrid::traverse(const glm::vec3& start, const glm::vec3& end, Visit visit) const {
+    // Amanatides-Woo grid walk in cell units relative to the grid origin
+    const float x0 = start.x * inverseCellSize - originX;
+    const float z0 = start.z * inverseCellSize - originZ;
+    const float x1 = end.x * inverseCellSize - originX;
+    const float z1 = end.z * inverseCellSize - originZ;
+
+    int32_t x = static_cast<int32_t>(std::floor(x0));
+    int32_t z = static_cast<int32_t>(std::floor(z0));
+    const int32_t endX = static_cast<int32_t>(std::floor(x1));
+    const int32_t endZ = static_cast<int32_t>(std::floor(z1));
+
+    const float dx = x1 - x0;
+    const float dz = z1 - z0;
+    const int32_t stepX = endX > x ? 1 : (endX < x ? -1 : 0);
+    const int32_t stepZ = endZ > z ? 1 : (endZ < z ? -1 : 0);
+    const float infinity = std::numeric_limits<float>::infinity();
+
+    // Segment parameter at which the walk crosses the next X / Z cell boundary
+    float tMaxX = stepX > 0 ? (x + 1 - x0) / dx : stepX < 0 ? (x0 - x) / -dx : infinity;
+    float tMaxZ = stepZ > 0 ? (z + 1 - z0) / dz : stepZ < 0 ? (z0 - z) / -dz : infinity;
+    const float tDeltaX = stepX != 0 ? 1.0f / std::abs(dx) : infinity;
+    const float tDeltaZ = stepZ != 0 ? 1.0f / std::abs(dz) : infinity;
+
+    if (!visit(x, z)) return false;
+
+    // Counting the steps keeps rounding from walking past the end cell
+    int32_t remaining = std::abs(endX - x) + std::abs(endZ - z);
+    while (remaining > 0) {
+        if (x != endX && z != endZ && tMaxX == tMaxZ) {
+            // Exactly through a corner: count both cells beside it as touched
+            if (!visit(x + stepX, z) || !visit(x, z + stepZ)) return false;
+            x += stepX;
+            z += stepZ;
+            tMaxX += tDeltaX;
+            tMaxZ += tDeltaZ;
+            remaining -= 2;
+        } else if (z == endZ || (x != endX && tMaxX < tMaxZ)) {
+            x += stepX;
+            tMaxX += tDeltaX;
+            remaining--;
+        } else {
+            z += stepZ;
+            tMaxZ += tDeltaZ;
+            remaining--;
+        }
+        if (!visit(x, z)) return false;
+    }
+    return true;
+}
+
+bool NavGrid::lineOfSight(const glm::vec3& start, const glm::vec3& end) const {
+    if (blockedCount == 0) return true;
+
+    return traverse(start, end, [this](int32_t x, int32_t z) {
+        int32_t index = cellIndex(x, z);
+        return index < 0 || !blocked[index];
+    });
+}
+
+void NavGrid::appendCellsOnSegment(const glm::vec3& start, const glm::vec3& end, std::vector<int32_t>& cells) const {
+    traverse(start, end, [this, &cells](int32_t x, int32_t z) {
+        int32_t index = cellIndex(x, z);
+        if (index >= 0) {
+            cells.push_back(index);
+        }
+        return true;
+    });
+}
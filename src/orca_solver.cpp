@@ -0,0 +1,203 @@
+// Adapted from the RVO2 Library (Agent.cpp: linearProgram1/2/3 and
+// Agent::computeNewVelocity), Copyright 2008 University of North Carolina at
+// Chapel Hill, licensed under the Apache License, Version 2.0; see NOTICE and
+// licenses/Apache-2.0.txt. Modified: ported to glm on the x/z ground plane,
+// split into free functions, per-neighbor responsibility shares.
+
+#include "orca_solver.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const float ORCA_EPSILON = 0.00001f;
+
+// Velocities on the left of direction (seen from point) are allowed
+struct OrcaLine {
+    glm::vec2 point;
+    glm::vec2 direction;
+};
+
+float det(const glm::vec2& a, const glm::vec2& b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+float lengthSquared(const glm::vec2& v) {
+    return glm::dot(v, v);
+}
+
+// Best velocity on line lineNo that satisfies lines [0, lineNo) and the speed circle
+bool solveOnLine(const std::vector<OrcaLine>& lines, size_t lineNo, float radius, const glm::vec2& optVelocity,
+                 bool directionOpt, glm::vec2& result) {
+    const OrcaLine& line = lines[lineNo];
+    const float dotProduct = glm::dot(line.point, line.direction);
+    const float discriminant = dotProduct * dotProduct + radius * radius - lengthSquared(line.point);
+    if (discriminant < 0.0f) {
+        // The speed circle misses the line entirely
+        return false;
+    }
+
+    const float sqrtDiscriminant = std::sqrt(discriminant);
+    float tLeft = -dotProduct - sqrtDiscriminant;
+    float tRight = -dotProduct + sqrtDiscriminant;
+
+    for (size_t i = 0; i < lineNo; ++i) {
+        const float denominator = det(line.direction, lines[i].direction);
+        const float numerator = det(lines[i].direction, line.point - lines[i].point);
+
+        if (std::fabs(denominator) <= ORCA_EPSILON) {
+            // Parallel lines: either this one is entirely outside the other or the other adds nothing
+            if (numerator < 0.0f) return false;
+            continue;
+        }
+
+        const float t = numerator / denominator;
+        if (denominator >= 0.0f) {
+            tRight = std::fmin(tRight, t);
+        } else {
+            tLeft = std::fmax(tLeft, t);
+        }
+        if (tLeft > tRight) return false;
+    }
+
+    if (directionOpt) {
+        // Go as far as possible in optVelocity's direction
+        result = line.point + line.direction * (glm::dot(optVelocity, line.direction) > 0.0f ? tRight : tLeft);
+    } else {
+        // Closest point on the allowed part of the line
+        float t = glm::dot(line.direction, optVelocity - line.point);
+        t = std::fmin(std::fmax(t, tLeft), tRight);
+        result = line.point + line.direction * t;
+    }
+    return true;
+}
+
+// Velocity closest to optVelocity (or furthest along it, with directionOpt)
+// satisfying every line; returns the index of the first line that could not
+// be satisfied, or lines.size()
+size_t solvePlanar(const std::vector<OrcaLine>& lines, float radius, const glm::vec2& optVelocity, bool directionOpt,
+                   glm::vec2& result) {
+    if (directionOpt) {
+        result = optVelocity * radius;
+    } else if (lengthSquared(optVelocity) > radius * radius) {
+        result = glm::normalize(optVelocity) * radius;
+    } else {
+        result = optVelocity;
+    }
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (det(lines[i].direction, lines[i].point - result) > 0.0f) {
+            // Outside this half-plane: the optimum moves onto its line
+            const glm::vec2 previous = result;
+            if (!solveOnLine(lines, i, radius, optVelocity, directionOpt, result)) {
+                result = previous;
+                return i;
+            }
+        }
+    }
+    return lines.size();
+}
+
+// Infeasible from beginLine on: minimize the largest violation instead
+void solveLeastPenetration(const std::vector<OrcaLine>& lines, size_t beginLine, float radius, glm::vec2& result) {
+    thread_local std::vector<OrcaLine> projectedLines;
+    float distance = 0.0f;
+
+    for (size_t i = beginLine; i < lines.size(); ++i) {
+        if (det(lines[i].direction, lines[i].point - result) <= distance) continue;
+
+        // Line i is violated more than any before it; project the earlier lines onto it
+        projectedLines.clear();
+        for (size_t j = 0; j < i; ++j) {
+            OrcaLine line;
+            const float determinant = det(lines[i].direction, lines[j].direction);
+            if (std::fabs(determinant) <= ORCA_EPSILON) {
+                // Parallel and pointing the same way: nothing to add
+                if (glm::dot(lines[i].direction, lines[j].direction) > 0.0f) continue;
+                line.point = (lines[i].point + lines[j].point) * 0.5f;
+            } else {
+                line.point = lines[i].point +
+                             lines[i].direction * (det(lines[j].direction, lines[i].point - lines[j].point) / determinant);
+            }
+            line.direction = glm::normalize(lines[j].direction - lines[i].direction);
+            projectedLines.push_back(line);
+        }
+
+        const glm::vec2 previous = result;
+        const glm::vec2 awayFromLine(-lines[i].direction.y, lines[i].direction.x);
+        if (solvePlanar(projectedLines, radius, awayFromLine, true, result) < projectedLines.size()) {
+            // Can only fail through rounding; keep the last result
+            result = previous;
+        }
+        distance = det(lines[i].direction, lines[i].point - result);
+    }
+}
+
+} // namespace
+
+glm::vec2 solveOrcaVelocity(const glm::vec2& position, const glm::vec2& velocity, float radius,
+                            const glm::vec2& preferredVelocity, float maxSpeed,
+                            const OrcaNeighbor* neighbors, size_t count,
+                            float timeHorizon, float deltaTime) {
+    thread_local std::vector<OrcaLine> lines;
+    lines.clear();
+
+    const float invTimeHorizon = 1.0f / timeHorizon;
+    for (size_t i = 0; i < count; ++i) {
+        const OrcaNeighbor& other = neighbors[i];
+        const glm::vec2 relativePosition = other.position - position;
+        const glm::vec2 relativeVelocity = velocity - other.velocity;
+        const float distanceSquared = lengthSquared(relativePosition);
+        const float combinedRadius = radius + other.radius;
+        const float combinedRadiusSquared = combinedRadius * combinedRadius;
+
+        OrcaLine line;
+        glm::vec2 u;
+        if (distanceSquared > combinedRadiusSquared) {
+            // Vector from the center of the truncated velocity obstacle's cutoff circle
+            const glm::vec2 w = relativeVelocity - relativePosition * invTimeHorizon;
+            const float wLengthSquared = lengthSquared(w);
+            const float dotProduct = glm::dot(w, relativePosition);
+
+            if (dotProduct < 0.0f && dotProduct * dotProduct > combinedRadiusSquared * wLengthSquared) {
+                // Closest to the cutoff circle
+                const float wLength = std::sqrt(wLengthSquared);
+                const glm::vec2 unitW = w / wLength;
+                line.direction = glm::vec2(unitW.y, -unitW.x);
+                u = unitW * (combinedRadius * invTimeHorizon - wLength);
+            } else {
+                // Closest to one of the cone's legs
+                const float leg = std::sqrt(distanceSquared - combinedRadiusSquared);
+                if (det(relativePosition, w) > 0.0f) {
+                    line.direction = glm::vec2(relativePosition.x * leg - relativePosition.y * combinedRadius,
+                                               relativePosition.x * combinedRadius + relativePosition.y * leg) /
+                                     distanceSquared;
+                } else {
+                    line.direction = -glm::vec2(relativePosition.x * leg + relativePosition.y * combinedRadius,
+                                                -relativePosition.x * combinedRadius + relativePosition.y * leg) /
+                                     distanceSquared;
+                }
+                u = line.direction * glm::dot(relativeVelocity, line.direction) - relativeVelocity;
+            }
+        } else {
+            // Already overlapping: separate within this step
+            const float invTimeStep = 1.0f / deltaTime;
+            const glm::vec2 w = relativeVelocity - relativePosition * invTimeStep;
+            const float wLength = glm::length(w);
+            if (wLength <= ORCA_EPSILON) continue; // Same position and velocity: no direction to pick
+            const glm::vec2 unitW = w / wLength;
+            line.direction = glm::vec2(unitW.y, -unitW.x);
+            u = unitW * (combinedRadius * invTimeStep - wLength);
+        }
+
+        line.point = velocity + u * other.responsibility;
+        lines.push_back(line);
+    }
+
+    glm::vec2 result;
+    size_t failedLine = solvePlanar(lines, maxSpeed, preferredVelocity, false, result);
+    if (failedLine < lines.size()) {
+        solveLeastPenetration(lines, failedLine, maxSpeed, result);
+    }
+    return result;
+}
@@ -0,0 +1,441 @@
+#include "path_hierarchy.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+const uint32_t UNREACHED = 0xFFFFFFFFu;
+
+// 8-connected neighborhood with integer octile step costs, as in PathService
+const int32_t NEIGHBOR_X[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+const int32_t NEIGHBOR_Z[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+const uint32_t NEIGHBOR_COST[8] = {10, 10, 10, 10, 14, 14, 14, 14};
+const uint32_t BORDER_STEP_COST = 10; // Entrances face each other orthogonally
+
+uint32_t octileDistance(int32_t dx, int32_t dz) {
+    uint32_t ax = static_cast<uint32_t>(std::abs(dx));
+    uint32_t az = static_cast<uint32_t>(std::abs(dz));
+    return 10 * std::max(ax, az) + 4 * std::min(ax, az);
+}
+
+struct OpenNode {
+    uint32_t estimate;
+    uint32_t heuristic;
+    int32_t state;
+};
+
+// Heap order: lowest estimate first, then closest to the goal, then lowest state
+bool openAfter(const OpenNode& a, const OpenNode& b) {
+    if (a.estimate != b.estimate) return a.estimate > b.estimate;
+    if (a.heuristic != b.heuristic) return a.heuristic > b.heuristic;
+    return a.state > b.state;
+}
+
+// Stamped cost/parent arrays over a state space, reset in O(1) per search
+struct SearchState {
+    std::vector<uint32_t> costs;
+    std::vector<int32_t> parents;
+    std::vector<uint32_t> stamps;
+    uint32_t stamp{0};
+    std::vector<OpenNode> open;
+
+    void begin(size_t stateCount) {
+        if (stamps.size() != stateCount || stamp == 0xFFFFFFFFu) {
+            costs.assign(stateCount, 0);
+            parents.assign(stateCount, -1);
+            stamps.assign(stateCount, 0);
+            stamp = 0;
+        }
+        stamp++;
+        open.clear();
+    }
+
+    uint32_t cost(int32_t state) const { return stamps[state] == stamp ? costs[state] : UNREACHED; }
+
+    // Record a cheaper way to reach state; returns false if it is not cheaper
+    bool relax(int32_t state, uint32_t cost, int32_t parent, uint32_t heuristic) {
+        if (stamps[state] == stamp && costs[state] <= cost) return false;
+        stamps[state] = stamp;
+        costs[state] = cost;
+        parents[state] = parent;
+        open.push_back({cost + heuristic, heuristic, state});
+        std::push_heap(open.begin(), open.end(), openAfter);
+        return true;
+    }
+
+    bool pop(OpenNode& node) {
+        while (!open.empty()) {
+            std::pop_heap(open.begin(), open.end(), openAfter);
+            node = open.back();
+            open.pop_back();
+            // Skip entries superseded by a cheaper push
+            if (node.estimate - node.heuristic == costs[node.state]) return true;
+        }
+        return false;
+    }
+};
+
+// Dijkstra from source over the open cells inside [minX, maxX) x [minZ, maxZ).
+// Stops early once stopCell is settled; returns the number of cells expanded.
+uint32_t searchRect(const NavGrid& grid, int32_t minX, int32_t minZ, int32_t maxX, int32_t maxZ, int32_t source,
+                    SearchState& search, int32_t stopCell = -1) {
+    const int32_t width = grid.getWidth();
+    search.begin(static_cast<size_t>(grid.getCellCount()));
+    search.relax(source, 0, -1, 0);
+
+    uint32_t expanded = 0;
+    OpenNode node;
+    while (search.pop(node)) {
+        expanded++;
+        if (node.state == stopCell) break;
+
+        const int32_t x = grid.cellX(node.state);
+        const int32_t z = grid.cellZ(node.state);
+        const uint32_t cost = search.costs[node.state];
+        for (int n = 0; n < 8; ++n) {
+            int32_t nx = x + NEIGHBOR_X[n];
+            int32_t nz = z + NEIGHBOR_Z[n];
+            if (nx < minX || nz < minZ || nx >= maxX || nz >= maxZ) continue;
+
+            int32_t next = nz * width + nx;
+            if (grid.isBlocked(next)) continue;
+            if (n >= 4 && (grid.isBlocked(z * width + nx) || grid.isBlocked(nz * width + x))) continue;
+
+            search.relax(next, cost + NEIGHBOR_COST[n], node.state, 0);
+        }
+    }
+    return expanded;
+}
+
+// Append the cells from the search source to target, excluding the source
+void appendBacktrack(const SearchState& search, int32_t target, std::vector<int32_t>& cells) {
+    size_t first = cells.size();
+    for (int32_t cell = target; search.parents[cell] >= 0; cell = search.parents[cell]) {
+        cells.push_back(cell);
+    }
+    std::reverse(cells.begin() + first, cells.end());
+}
+
+} // namespace
+
+PathHierarchy::PathHierarchy(const NavGrid& grid)
+    : grid(grid)
+    , clustersX(0)
+    , clustersZ(0)
+    , gridWidth(0)
+    , gridHeight(0)
+{
+}
+
+int32_t PathHierarchy::clusterOf(int32_t cell) const {
+    return (grid.cellZ(cell) / CLUSTER_SIZE) * clustersX + grid.cellX(cell) / CLUSTER_SIZE;
+}
+
+int32_t PathHierarchy::clusterDistance(int32_t cellA, int32_t cellB) const {
+    int32_t dx = std::abs(grid.cellX(cellA) / CLUSTER_SIZE - grid.cellX(cellB) / CLUSTER_SIZE);
+    int32_t dz = std::abs(grid.cellZ(cellA) / CLUSTER_SIZE - grid.cellZ(cellB) / CLUSTER_SIZE);
+    return std::max(dx, dz);
+}
+
+uint32_t PathHierarchy::getNodeCount() const {
+    uint32_t count = 0;
+    for (const Cluster& cluster : clusters) {
+        count += static_cast<uint32_t>(cluster.nodes.size());
+    }
+    return count;
+}
+
+int32_t PathHierarchy::nodeIndex(const Cluster& cluster, int32_t cell) const {
+    auto it = std::find(cluster.nodes.begin(), cluster.nodes.end(), cell);
+    return it == cluster.nodes.end() ? -1 : static_cast<int32_t>(it - cluster.nodes.begin());
+}
+
+void PathHierarchy::rebuild() {
+    gridWidth = grid.getWidth();
+    gridHeight = grid.getHeight();
+    clustersX = (gridWidth + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    clustersZ = (gridHeight + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+
+    clusters.assign(static_cast<size_t>(clustersX) * clustersZ, Cluster());
+    borders.assign(clusters.size() * 2, Border());
+    for (int32_t cz = 0; cz < clustersZ; ++cz) {
+        for (int32_t cx = 0; cx < clustersX; ++cx) {
+            Cluster& cluster = clusters[cz * clustersX + cx];
+            cluster.minX = cx * CLUSTER_SIZE;
+            cluster.minZ = cz * CLUSTER_SIZE;
+            cluster.maxX = std::min(gridWidth, cluster.minX + CLUSTER_SIZE);
+            cluster.maxZ = std::min(gridHeight, cluster.minZ + CLUSTER_SIZE);
+        }
+    }
+
+    for (int32_t c = 0; c < getClusterCount(); ++c) {
+        buildBorder(c, false);
+        buildBorder(c, true);
+    }
+    for (int32_t c = 0; c < getClusterCount(); ++c) {
+        linkCluster(c);
+    }
+}
+
+void PathHierarchy::update(const std::vector<int32_t>& changedCells) {
+    if (clusters.empty() || gridWidth != grid.getWidth() || gridHeight != grid.getHeight()) {
+        rebuild();
+        return;
+    }
+
+    std::vector<uint8_t> dirty(clusters.size(), 0);
+    for (int32_t cell : changedCells) {
+        dirty[clusterOf(cell)] = 1;
+    }
+
+    // A cluster's entrances sit on its four borders; its neighbors share them
+    std::vector<uint8_t> relink(clusters.size(), 0);
+    for (int32_t c = 0; c < getClusterCount(); ++c) {
+        if (!dirty[c]) continue;
+
+        int32_t cx = c % clustersX;
+        int32_t cz = c / clustersX;
+        buildBorder(c, false);
+        buildBorder(c, true);
+        relink[c] = 1;
+        if (cx > 0) {
+            buildBorder(c - 1, false);
+            relink[c - 1] = 1;
+        }
+        if (cz > 0) {
+            buildBorder(c - clustersX, true);
+            relink[c - clustersX] = 1;
+        }
+        if (cx + 1 < clustersX) relink[c + 1] = 1;
+        if (cz + 1 < clustersZ) relink[c + clustersX] = 1;
+    }
+
+    for (int32_t c = 0; c < getClusterCount(); ++c) {
+        if (relink[c]) {
+            linkCluster(c);
+        }
+    }
+}
+
+void PathHierarchy::buildBorder(int32_t c, bool south) {
+    Border& border = borders[c * 2 + (south ? 1 : 0)];
+    border.inner.clear();
+    border.outer.clear();
+
+    const Cluster& cluster = clusters[c];
+    const int32_t width = grid.getWidth();
+    if (south ? cluster.maxZ >= gridHeight : cluster.maxX >= gridWidth) return;
+
+    // Walk along the border; (inner, outer) are the facing cells at each step
+    const int32_t length = south ? cluster.maxX - cluster.minX : cluster.maxZ - cluster.minZ;
+    auto innerCell = [&](int32_t i) {
+        return south ? (cluster.maxZ - 1) * width + cluster.minX + i : (cluster.minZ + i) * width + cluster.maxX - 1;
+    };
+    auto outerCell = [&](int32_t i) { return south ? innerCell(i) + width : innerCell(i) + 1; };
+    auto addEntrance = [&](int32_t i) {
+        border.inner.push_back(innerCell(i));
+        border.outer.push_back(outerCell(i));
+    };
+
+    int32_t runStart = -1;
+    for (int32_t i = 0; i <= length; ++i) {
+        bool open = i < length && !grid.isBlocked(innerCell(i)) && !grid.isBlocked(outerCell(i));
+        if (open && runStart < 0) {
+            runStart = i;
+        } else if (!open && runStart >= 0) {
+            int32_t runLength = i - runStart;
+            if (runLength >= LONG_ENTRANCE) {
+                addEntrance(runStart);
+                addEntrance(i - 1);
+            } else {
+                addEntrance(runStart + runLength / 2);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+void PathHierarchy::linkCluster(int32_t c) {
+    Cluster& cluster = clusters[c];
+    cluster.nodes.clear();
+    cluster.exits.clear();
+
+    auto addNode = [&](int32_t cell, int32_t exit) {
+        int32_t index = nodeIndex(cluster, cell);
+        if (index < 0) {
+            index = static_cast<int32_t>(cluster.nodes.size());
+            cluster.nodes.push_back(cell);
+            cluster.exits.emplace_back();
+        }
+        cluster.exits[index].push_back(exit);
+    };
+
+    // Own east and south borders, then the west and north ones owned by the neighbors
+    const int32_t cx = c % clustersX;
+    const int32_t cz = c / clustersX;
+    for (int side = 0; side < 2; ++side) {
+        const Border& border = borders[c * 2 + side];
+        for (size_t i = 0; i < border.inner.size(); ++i) {
+            addNode(border.inner[i], border.outer[i]);
+        }
+    }
+    if (cx > 0) {
+        const Border& west = borders[(c - 1) * 2];
+        for (size_t i = 0; i < west.inner.size(); ++i) {
+            addNode(west.outer[i], west.inner[i]);
+        }
+    }
+    if (cz > 0) {
+        const Border& north = borders[(c - clustersX) * 2 + 1];
+        for (size_t i = 0; i < north.inner.size(); ++i) {
+            addNode(north.outer[i], north.inner[i]);
+        }
+    }
+
+    // Paths between every pair of nodes without leaving the cluster
+    const size_t n = cluster.nodes.size();
+    cluster.costs.assign(n * n, NO_PATH);
+    cluster.paths.assign(n * n, std::vector<int32_t>());
+
+    thread_local SearchState search;
+    for (size_t i = 0; i < n; ++i) {
+        searchRect(grid, cluster.minX, cluster.minZ, cluster.maxX, cluster.maxZ, cluster.nodes[i], search);
+        for (size_t j = 0; j < n; ++j) {
+            cluster.costs[i * n + j] = search.cost(cluster.nodes[j]);
+            if (j > i && cluster.costs[i * n + j] != NO_PATH) {
+                appendBacktrack(search, cluster.nodes[j], cluster.paths[i * n + j]);
+            }
+        }
+    }
+}
+
+bool PathHierarchy::findCorridor(int32_t startCell, int32_t goalCell, std::vector<int32_t>& corridor,
+                                 uint32_t& expanded) const {
+    expanded = 0;
+    if (clusters.empty() || grid.isBlocked(goalCell)) return false;
+
+    thread_local SearchState local;
+    thread_local SearchState abstract;
+    thread_local std::vector<uint32_t> startCosts;
+    thread_local std::vector<uint32_t> goalCosts;
+
+    const int32_t startCluster = clusterOf(startCell);
+    const int32_t goalCluster = clusterOf(goalCell);
+    const Cluster& start = clusters[startCluster];
+    const Cluster& goal = clusters[goalCluster];
+
+    // Link start and goal to the nodes of their clusters
+    expanded += searchRect(grid, start.minX, start.minZ, start.maxX, start.maxZ, startCell, local);
+    startCosts.resize(start.nodes.size());
+    for (size_t i = 0; i < start.nodes.size(); ++i) {
+        startCosts[i] = local.cost(start.nodes[i]);
+    }
+    uint32_t directCost = startCluster == goalCluster ? local.cost(goalCell) : NO_PATH;
+
+    expanded += searchRect(grid, goal.minX, goal.minZ, goal.maxX, goal.maxZ, goalCell, local);
+    goalCosts.resize(goal.nodes.size());
+    for (size_t i = 0; i < goal.nodes.size(); ++i) {
+        goalCosts[i] = local.cost(goal.nodes[i]);
+    }
+
+    // A* over the node graph; the goal is one extra state past the last cell
+    const int32_t goalState = grid.getCellCount();
+    const int32_t goalX = grid.cellX(goalCell);
+    const int32_t goalZ = grid.cellZ(goalCell);
+    auto heuristic = [&](int32_t cell) { return octileDistance(grid.cellX(cell) - goalX, grid.cellZ(cell) - goalZ); };
+
+    abstract.begin(static_cast<size_t>(goalState) + 1);
+    if (directCost != NO_PATH) {
+        abstract.relax(goalState, directCost, -1, 0);
+    }
+    for (size_t i = 0; i < start.nodes.size(); ++i) {
+        if (startCosts[i] != NO_PATH) {
+            abstract.relax(start.nodes[i], startCosts[i], -1, heuristic(start.nodes[i]));
+        }
+    }
+
+    bool reached = false;
+    OpenNode node;
+    while (abstract.pop(node)) {
+        if (node.state == goalState) {
+            reached = true;
+            break;
+        }
+        expanded++;
+
+        const int32_t c = clusterOf(node.state);
+        const Cluster& cluster = clusters[c];
+        const size_t n = cluster.nodes.size();
+        const size_t i = static_cast<size_t>(nodeIndex(cluster, node.state));
+        const uint32_t cost = abstract.costs[node.state];
+
+        if (c == goalCluster && goalCosts[i] != NO_PATH) {
+            abstract.relax(goalState, cost + goalCosts[i], node.state, 0);
+        }
+        for (size_t j = 0; j < n; ++j) {
+            uint32_t step = cluster.costs[i * n + j];
+            if (j != i && step != NO_PATH) {
+                abstract.relax(cluster.nodes[j], cost + step, node.state, heuristic(cluster.nodes[j]));
+            }
+        }
+        for (int32_t exit : cluster.exits[i]) {
+            abstract.relax(exit, cost + BORDER_STEP_COST, node.state, heuristic(exit));
+        }
+    }
+
+    if (!reached) return false;
+
+    corridor.clear();
+    corridor.push_back(goalCell);
+    for (int32_t state = abstract.parents[goalState]; state >= 0; state = abstract.parents[state]) {
+        if (state != corridor.back()) {
+            corridor.push_back(state);
+        }
+    }
+    if (startCell != corridor.back()) {
+        corridor.push_back(startCell);
+    }
+    std::reverse(corridor.begin(), corridor.end());
+    return true;
+}
+
+bool PathHierarchy::refineSegment(int32_t fromCell, int32_t toCell, std::vector<int32_t>& cells) const {
+    if (fromCell == toCell) return true;
+
+    const int32_t c = clusterOf(fromCell);
+    if (c != clusterOf(toCell)) {
+        // Crossing an entrance: the cells face each other
+        cells.push_back(toCell);
+        return true;
+    }
+
+    // Between two nodes: precomputed, stored once per pair
+    const Cluster& cluster = clusters[c];
+    const int32_t i = nodeIndex(cluster, fromCell);
+    const int32_t j = nodeIndex(cluster, toCell);
+    if (i >= 0 && j >= 0) {
+        const size_t n = cluster.nodes.size();
+        if (cluster.costs[i * n + j] == NO_PATH) return false;
+
+        if (i < j) {
+            const std::vector<int32_t>& path = cluster.paths[i * n + j];
+            cells.insert(cells.end(), path.begin(), path.end());
+        } else {
+            // Stored from j to i (excluding j); walk it back and end on j
+            const std::vector<int32_t>& path = cluster.paths[j * n + i];
+            for (size_t k = path.size() - 1; k-- > 0;) {
+                cells.push_back(path[k]);
+            }
+            cells.push_back(toCell);
+        }
+        return true;
+    }
+
+    // Leaving the start or reaching the goal: search just this cluster
+    thread_local SearchState local;
+    searchRect(grid, cluster.minX, cluster.minZ, cluster.maxX, cluster.maxZ, fromCell, local, toCell);
+    if (local.cost(toCell) == UNREACHED) return false;
+
+    appendBacktrack(local, toCell, cells);
+    return true;
+}
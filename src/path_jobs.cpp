@@ -0,0 +1,203 @@
+#include "path_jobs.h"
+#include <algorithm>
+
+PathJobQueue::PathJobQueue(PathService& service, size_t workerCount)
+    : service(service)
+    , workerCount(workerCount)
+    , commitsPerTick(DEFAULT_COMMITS_PER_TICK)
+    , nextJob(0)
+    , busyWorkers(0)
+    , searchedVersion(service.getVersion())
+    , running(false)
+    , stopping(false)
+    , stats{}
+{
+}
+
+PathJobQueue::~PathJobQueue() {
+    stopWorkers();
+}
+
+void PathJobQueue::request(EntityHandle requester, const glm::vec3& start, const glm::vec3& goal, uint32_t order) {
+    std::lock_guard<std::mutex> lock(mutex);
+    recorded.push_back({requester, start, goal, order});
+    stats.requested++;
+}
+
+void PathJobQueue::beginTick() {
+    bool start;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Results searched ahead on an older grid would differ from a search
+        // now; no worker is running, so start the whole queue over
+        if (searchedVersion != service.getVersion()) {
+            for (size_t i = 0; i < nextJob; ++i) {
+                Job& job = jobs[i];
+                if (job.done && !job.replaced) {
+                    stats.researched++;
+                }
+                job.path = nullptr;
+                job.taken = false;
+                job.done = false;
+            }
+            nextJob = 0;
+            searchedVersion = service.getVersion();
+        }
+
+        // Requests may have been recorded from several threads
+        std::stable_sort(recorded.begin(), recorded.end(),
+                         [](const Request& a, const Request& b) { return a.order < b.order; });
+
+        for (const Request& request : recorded) {
+            auto latest = latestJobs.find(request.requester.value);
+            if (latest != latestJobs.end()) {
+                latest->second->replaced = true;
+                stats.replaced++;
+            }
+            jobs.push_back({request, nullptr, false, false, false});
+            latestJobs[request.requester.value] = &jobs.back();
+        }
+        recorded.clear();
+
+        stats.maxBacklog = std::max(stats.maxBacklog, jobs.size());
+        running = true;
+        start = workers.empty() && workerCount > 0 && nextJob < jobs.size();
+    }
+
+    if (start) {
+        startWorkers();
+    }
+    workCondition.notify_all();
+}
+
+void PathJobQueue::endTick(std::vector<Result>& committed) {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // The oldest live jobs are committed this tick whether or not the workers
+    // got to them; help out with the queue rather than idle
+    uint32_t live = 0;
+    for (size_t i = 0; i < jobs.size() && live < commitsPerTick; ++i) {
+        const Job& job = jobs[i];
+        if (job.replaced) continue;
+        live++;
+
+        if (!job.done) {
+            stats.waits++;
+            while (!job.done) {
+                if (nextJob < jobs.size()) {
+                    runNextJob(lock);
+                } else {
+                    doneCondition.wait(lock);
+                }
+            }
+        }
+    }
+
+    // Let searches already started finish; the rest wait for the next tick
+    running = false;
+    doneCondition.wait(lock, [this] { return busyWorkers == 0; });
+
+    uint32_t count = 0;
+    while (!jobs.empty() && (count < commitsPerTick || jobs.front().replaced)) {
+        Job& job = jobs.front();
+        if (!job.replaced) {
+            committed.push_back({job.request.requester, std::move(job.path)});
+            count++;
+        }
+
+        auto latest = latestJobs.find(job.request.requester.value);
+        if (latest != latestJobs.end() && latest->second == &job) {
+            latestJobs.erase(latest);
+        }
+        // Taken jobs are always a prefix of the queue
+        if (job.taken) {
+            nextJob--;
+        }
+        jobs.pop_front();
+    }
+    stats.committed += count;
+}
+
+void PathJobQueue::setWorkerCount(size_t count) {
+    if (count == workerCount) return;
+    stopWorkers();
+    workerCount = count;
+}
+
+size_t PathJobQueue::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t pending = recorded.size();
+    for (const Job& job : jobs) {
+        if (!job.replaced) pending++;
+    }
+    return pending;
+}
+
+void PathJobQueue::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    recorded.clear();
+    jobs.clear();
+    latestJobs.clear();
+    nextJob = 0;
+}
+
+PathJobQueue::Stats PathJobQueue::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void PathJobQueue::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats = Stats{};
+}
+
+void PathJobQueue::startWorkers() {
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&PathJobQueue::workerLoop, this);
+    }
+}
+
+void PathJobQueue::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workCondition.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    stopping = false;
+}
+
+void PathJobQueue::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        workCondition.wait(lock, [this] { return stopping || (running && nextJob < jobs.size()); });
+        if (stopping) return;
+        runNextJob(lock);
+    }
+}
+
+void PathJobQueue::runNextJob(std::unique_lock<std::mutex>& lock) {
+    Job& job = jobs[nextJob++];
+    job.taken = true;
+    if (job.replaced) {
+        job.done = true;
+        return;
+    }
+
+    // The queue is only popped once no search is running, so job stays put
+    busyWorkers++;
+    lock.unlock();
+    std::shared_ptr<const PathService::Path> path = service.findPath(job.request.start, job.request.goal);
+    lock.lock();
+    busyWorkers--;
+
+    job.path = std::move(path);
+    job.done = true;
+    doneCondition.notify_all();
+}
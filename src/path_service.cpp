@@ -0,0 +1,386 @@
+#include "path_service.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// 8-connected neighborhood with integer octile step costs, as in FlowField
+const int32_t NEIGHBOR_X[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+const int32_t NEIGHBOR_Z[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+const uint32_t NEIGHBOR_COST[8] = {10, 10, 10, 10, 14, 14, 14, 14};
+
+struct OpenNode {
+    uint32_t estimate; // Cost so far plus heuristic
+    uint32_t heuristic;
+    int32_t cell;
+};
+
+// Heap order: lowest estimate first, then closest to the goal, then lowest cell index
+bool openAfter(const OpenNode& a, const OpenNode& b) {
+    if (a.estimate != b.estimate) return a.estimate > b.estimate;
+    if (a.heuristic != b.heuristic) return a.heuristic > b.heuristic;
+    return a.cell > b.cell;
+}
+
+uint32_t octileDistance(int32_t dx, int32_t dz) {
+    uint32_t ax = static_cast<uint32_t>(std::abs(dx));
+    uint32_t az = static_cast<uint32_t>(std::abs(dz));
+    return 10 * std::max(ax, az) + 4 * std::min(ax, az);
+}
+
+// Per-thread search state; a search stamp marks which entries are current
+struct SearchScratch {
+    std::vector<uint32_t> costs;
+    std::vector<int32_t> parents;
+    std::vector<uint32_t> stamps;
+    uint32_t stamp{0};
+    std::vector<OpenNode> open;
+    std::vector<int32_t> cellPath;
+
+    void begin(size_t cellCount) {
+        if (stamps.size() != cellCount || stamp == 0xFFFFFFFFu) {
+            costs.assign(cellCount, 0);
+            parents.assign(cellCount, -1);
+            stamps.assign(cellCount, 0);
+            stamp = 0;
+        }
+        stamp++;
+        open.clear();
+        cellPath.clear();
+    }
+};
+
+} // namespace
+
+PathService::PathService(const NavGrid& grid, size_t cacheCapacity)
+    : grid(grid)
+    , cacheCapacity(cacheCapacity)
+    , hierarchy(grid)
+    , hierarchical(true)
+    , version(0)
+    , useCounter(0)
+    , stats{}
+{
+}
+
+uint64_t PathService::cacheKey(int32_t startCell, int32_t goalCell) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(startCell)) << 32 | static_cast<uint32_t>(goalCell);
+}
+
+std::shared_ptr<const PathService::Path> PathService::findPath(const glm::vec3& start, const glm::vec3& goal) {
+    int32_t startCell = grid.cellIndex(start);
+    int32_t goalCell = grid.cellIndex(goal);
+    if (startCell < 0 || goalCell < 0) return nullptr;
+
+    const uint64_t key = cacheKey(startCell, goalCell);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.queries++;
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            stats.cacheHits++;
+            it->second.lastUse = ++useCounter;
+            return it->second.path;
+        }
+    }
+
+    // Miss: search without holding the lock
+    auto path = std::make_shared<Path>();
+    path->startCell = startCell;
+    path->goalCell = goalCell;
+    path->stale = false;
+
+    CacheEntry entry;
+    uint32_t expanded = 0;
+    // A start inside a blocked cell has no way into the hierarchy; the flat search can still leave it
+    bool longQuery = hierarchical && hierarchy.isBuilt() && hierarchy.clusterDistance(startCell, goalCell) > 1 &&
+                     !grid.isBlocked(startCell);
+    if (longQuery) {
+        hierarchy.findCorridor(startCell, goalCell, path->corridor, expanded);
+        for (int32_t cell : path->corridor) {
+            entry.cells.push_back(hierarchy.clusterOf(cell));
+        }
+    } else {
+        expanded = search(startCell, goalCell, *path, entry.cells);
+    }
+    std::sort(entry.cells.begin(), entry.cells.end());
+    entry.cells.erase(std::unique(entry.cells.begin(), entry.cells.end()), entry.cells.end());
+    entry.path = path;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.searches++;
+    stats.hierarchicalSearches += longQuery ? 1 : 0;
+    stats.expandedNodes += expanded;
+
+    // Another thread may have searched the same key meanwhile; keep the first
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        it->second.lastUse = ++useCounter;
+        return it->second.path;
+    }
+
+    entry.lastUse = ++useCounter;
+    insert(key, std::move(entry));
+    return path;
+}
+
+uint32_t PathService::search(int32_t startCell, int32_t goalCell, Path& path, std::vector<int32_t>& crossedCells) const {
+    if (grid.isBlocked(goalCell)) return 0;
+
+    thread_local SearchScratch scratch;
+    scratch.begin(static_cast<size_t>(grid.getCellCount()));
+
+    const int32_t width = grid.getWidth();
+    const int32_t height = grid.getHeight();
+    const int32_t goalX = grid.cellX(goalCell);
+    const int32_t goalZ = grid.cellZ(goalCell);
+
+    auto heuristic = [&](int32_t cell) { return octileDistance(grid.cellX(cell) - goalX, grid.cellZ(cell) - goalZ); };
+
+    // The start cell is searched even if blocked, so a mob pressed into a wall can still leave
+    scratch.stamps[startCell] = scratch.stamp;
+    scratch.costs[startCell] = 0;
+    scratch.parents[startCell] = -1;
+    uint32_t startHeuristic = heuristic(startCell);
+    scratch.open.push_back({startHeuristic, startHeuristic, startCell});
+
+    uint32_t expanded = 0;
+    bool reached = false;
+    while (!scratch.open.empty() && expanded < MAX_EXPANDED_NODES) {
+        std::pop_heap(scratch.open.begin(), scratch.open.end(), openAfter);
+        OpenNode node = scratch.open.back();
+        scratch.open.pop_back();
+
+        // Skip entries superseded by a cheaper push
+        if (node.estimate - node.heuristic != scratch.costs[node.cell]) continue;
+
+        expanded++;
+        if (node.cell == goalCell) {
+            reached = true;
+            break;
+        }
+
+        const int32_t x = grid.cellX(node.cell);
+        const int32_t z = grid.cellZ(node.cell);
+        const uint32_t cost = scratch.costs[node.cell];
+        for (int n = 0; n < 8; ++n) {
+            int32_t nx = x + NEIGHBOR_X[n];
+            int32_t nz = z + NEIGHBOR_Z[n];
+            if (nx < 0 || nz < 0 || nx >= width || nz >= height) continue;
+
+            int32_t next = nz * width + nx;
+            if (grid.isBlocked(next)) continue;
+
+            // Diagonal steps need both orthogonal cells open
+            if (n >= 4 && (grid.isBlocked(z * width + nx) || grid.isBlocked(nz * width + x))) continue;
+
+            uint32_t nextCost = cost + NEIGHBOR_COST[n];
+            if (scratch.stamps[next] == scratch.stamp && scratch.costs[next] <= nextCost) continue;
+
+            scratch.stamps[next] = scratch.stamp;
+            scratch.costs[next] = nextCost;
+            scratch.parents[next] = node.cell;
+
+            uint32_t h = heuristic(next);
+            scratch.open.push_back({nextCost + h, h, next});
+            std::push_heap(scratch.open.begin(), scratch.open.end(), openAfter);
+        }
+    }
+
+    if (!reached) return expanded;
+
+    for (int32_t cell = goalCell; cell >= 0; cell = scratch.parents[cell]) {
+        scratch.cellPath.push_back(cell);
+    }
+    std::reverse(scratch.cellPath.begin(), scratch.cellPath.end());
+
+    pullString(scratch.cellPath, path.waypoints, &crossedCells);
+    return expanded;
+}
+
+void PathService::pullString(const std::vector<int32_t>& cells, std::vector<glm::vec3>& waypoints,
+                             std::vector<int32_t>* crossedCells) const {
+    // Already in the last cell: a single waypoint at its center
+    if (cells.size() == 1) {
+        waypoints.push_back(grid.cellCenter(cells[0]));
+        if (crossedCells) crossedCells->push_back(cells[0]);
+        return;
+    }
+
+    // From each anchor, skip ahead to the furthest cell still in sight
+    size_t anchor = 0;
+    glm::vec3 anchorPosition = grid.cellCenter(cells[0]);
+    while (anchor + 1 < cells.size()) {
+        size_t next = anchor + 1;
+        while (next + 1 < cells.size() && grid.lineOfSight(anchorPosition, grid.cellCenter(cells[next + 1]))) {
+            next++;
+        }
+
+        glm::vec3 waypoint = grid.cellCenter(cells[next]);
+        if (crossedCells) {
+            grid.appendCellsOnSegment(anchorPosition, waypoint, *crossedCells);
+        }
+        waypoints.push_back(waypoint);
+        anchor = next;
+        anchorPosition = waypoint;
+    }
+}
+
+void PathService::refineSegment(const Path& path, size_t segment, std::vector<glm::vec3>& waypoints) const {
+    if (path.corridor.empty()) {
+        if (segment == 0) {
+            waypoints.insert(waypoints.end(), path.waypoints.begin(), path.waypoints.end());
+        }
+        return;
+    }
+    if (segment + 1 >= path.corridor.size()) return;
+
+    thread_local std::vector<int32_t> cells;
+    cells.clear();
+    cells.push_back(path.corridor[segment]);
+    if (!hierarchy.refineSegment(path.corridor[segment], path.corridor[segment + 1], cells)) {
+        // Only if the grid changed under a stale path; head for the next node directly
+        waypoints.push_back(grid.cellCenter(path.corridor[segment + 1]));
+        return;
+    }
+    pullString(cells, waypoints, nullptr);
+}
+
+void PathService::setHierarchical(bool enabled) {
+    hierarchical = enabled;
+    clearCache();
+    version++;
+}
+
+void PathService::insert(uint64_t key, CacheEntry entry) {
+    if (cache.size() >= cacheCapacity) {
+        evictOldest();
+    }
+
+    if (entry.path->found()) {
+        auto& index = entry.path->corridor.empty() ? cellEntries : clusterEntries;
+        for (int32_t cell : entry.cells) {
+            index[cell].push_back(key);
+        }
+    } else {
+        unreachableEntries.push_back(key);
+    }
+    cache.emplace(key, std::move(entry));
+}
+
+void PathService::erase(uint64_t key) {
+    auto it = cache.find(key);
+    if (it == cache.end()) return;
+
+    if (it->second.path->found()) {
+        auto& index = it->second.path->corridor.empty() ? cellEntries : clusterEntries;
+        for (int32_t cell : it->second.cells) {
+            auto listed = index.find(cell);
+            if (listed == index.end()) continue;
+
+            std::vector<uint64_t>& keys = listed->second;
+            auto position = std::find(keys.begin(), keys.end(), key);
+            if (position != keys.end()) {
+                *position = keys.back();
+                keys.pop_back();
+            }
+            if (keys.empty()) {
+                index.erase(listed);
+            }
+        }
+    } else {
+        auto position = std::find(unreachableEntries.begin(), unreachableEntries.end(), key);
+        if (position != unreachableEntries.end()) {
+            *position = unreachableEntries.back();
+            unreachableEntries.pop_back();
+        }
+    }
+    cache.erase(it);
+}
+
+void PathService::evictOldest() {
+    // Drop the least recently used half in one pass rather than one entry per insert
+    std::vector<std::pair<uint64_t, uint64_t>> byUse;
+    byUse.reserve(cache.size());
+    for (const auto& item : cache) {
+        byUse.push_back({item.second.lastUse, item.first});
+    }
+
+    size_t evictCount = std::max<size_t>(1, byUse.size() / 2);
+    std::nth_element(byUse.begin(), byUse.begin() + (evictCount - 1), byUse.end());
+    for (size_t i = 0; i < evictCount; ++i) {
+        erase(byUse[i].second);
+    }
+}
+
+void PathService::invalidate(const std::vector<int32_t>& changedCells) {
+    std::lock_guard<std::mutex> lock(mutex);
+    hierarchy.update(changedCells);
+
+    bool opened = false;
+    std::vector<uint64_t> affected;
+    for (int32_t cell : changedCells) {
+        if (!grid.isBlocked(cell)) {
+            opened = true;
+        }
+        auto listed = cellEntries.find(cell);
+        if (listed != cellEntries.end()) {
+            affected.insert(affected.end(), listed->second.begin(), listed->second.end());
+        }
+        listed = clusterEntries.find(hierarchy.clusterOf(cell));
+        if (listed != clusterEntries.end()) {
+            affected.insert(affected.end(), listed->second.begin(), listed->second.end());
+        }
+    }
+
+    // An opened cell may connect what was unreachable before
+    if (opened) {
+        affected.insert(affected.end(), unreachableEntries.begin(), unreachableEntries.end());
+    }
+
+    for (uint64_t key : affected) {
+        auto it = cache.find(key);
+        if (it == cache.end()) continue;
+
+        it->second.path->stale = true;
+        stats.invalidated++;
+        erase(key);
+    }
+
+    // The rest are still walkable but may no longer be what a search finds
+    // (an opened cell can make a shorter route). Keeping them would make
+    // results depend on which searches happened to run before the change.
+    if (!changedCells.empty()) {
+        cache.clear();
+        cellEntries.clear();
+        clusterEntries.clear();
+        unreachableEntries.clear();
+        version++;
+    }
+}
+
+void PathService::clearCache() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& item : cache) {
+        item.second.path->stale = true;
+    }
+    cache.clear();
+    cellEntries.clear();
+    clusterEntries.clear();
+    unreachableEntries.clear();
+}
+
+size_t PathService::getCacheSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cache.size();
+}
+
+PathService::Stats PathService::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void PathService::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats = Stats{};
+}
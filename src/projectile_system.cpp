@@ -0,0 +1,210 @@
+#include "projectile_system.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Fraction of the step [0, 1] at which a point moving by motion from offset
+// (point minus mob center, XZ only) comes within reach, or -1 for none
+float stepTimeOfImpact(float offsetX, float offsetZ, float motionX, float motionZ, float reach) {
+    float c = offsetX * offsetX + offsetZ * offsetZ - reach * reach;
+    if (c <= 0.0f) return 0.0f; // Started inside
+
+    float b = offsetX * motionX + offsetZ * motionZ;
+    float a = motionX * motionX + motionZ * motionZ;
+    if (b >= 0.0f || a <= 0.0f) return -1.0f;
+
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) return -1.0f;
+
+    float t = (-b - std::sqrt(discriminant)) / a;
+    return t <= 1.0f ? t : -1.0f;
+}
+
+} // namespace
+
+ProjectileSystem::ProjectileSystem(size_t capacity)
+    : capacity(0)
+    , count(0)
+    , stats{}
+{
+    setCapacity(capacity);
+}
+
+void ProjectileSystem::fire(const Shot& shot, uint32_t order) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    queued.push_back({shot, order, static_cast<uint32_t>(queued.size())});
+}
+
+bool ProjectileSystem::hasQueuedShots() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return !queued.empty();
+}
+
+void ProjectileSystem::setCapacity(size_t newCapacity) {
+    capacity = newCapacity;
+    count = std::min(count, capacity);
+
+    positionsX.resize(capacity);
+    positionsY.resize(capacity);
+    positionsZ.resize(capacity);
+    velocitiesX.resize(capacity);
+    velocitiesY.resize(capacity);
+    velocitiesZ.resize(capacity);
+    lifetimes.resize(capacity);
+    radii.resize(capacity);
+    damages.resize(capacity);
+    owners.resize(capacity);
+    ownerKinds.resize(capacity);
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    queued.reserve(capacity);
+    adding.reserve(capacity);
+}
+
+void ProjectileSystem::clear() {
+    count = 0;
+    std::lock_guard<std::mutex> lock(queueMutex);
+    queued.clear();
+}
+
+void ProjectileSystem::add(const Shot& shot) {
+    stats.fired++;
+    if (count == capacity) {
+        stats.dropped++;
+        return;
+    }
+
+    const size_t i = count++;
+    positionsX[i] = shot.position.x;
+    positionsY[i] = shot.position.y;
+    positionsZ[i] = shot.position.z;
+    velocitiesX[i] = shot.velocity.x;
+    velocitiesY[i] = shot.velocity.y;
+    velocitiesZ[i] = shot.velocity.z;
+    lifetimes[i] = shot.lifetime;
+    radii[i] = shot.radius;
+    damages[i] = shot.damage;
+    owners[i] = shot.owner;
+    ownerKinds[i] = shot.ownerKind;
+}
+
+void ProjectileSystem::removeAt(size_t i) {
+    const size_t last = --count;
+    if (i == last) return;
+
+    positionsX[i] = positionsX[last];
+    positionsY[i] = positionsY[last];
+    positionsZ[i] = positionsZ[last];
+    velocitiesX[i] = velocitiesX[last];
+    velocitiesY[i] = velocitiesY[last];
+    velocitiesZ[i] = velocitiesZ[last];
+    lifetimes[i] = lifetimes[last];
+    radii[i] = radii[last];
+    damages[i] = damages[last];
+    owners[i] = owners[last];
+    ownerKinds[i] = ownerKinds[last];
+}
+
+void ProjectileSystem::integrate(float deltaTime) {
+    // Separate unit-stride loops over restrict pointers so each one vectorizes
+    const size_t n = count;
+    float* __restrict x = positionsX.data();
+    float* __restrict y = positionsY.data();
+    float* __restrict z = positionsZ.data();
+    const float* __restrict vx = velocitiesX.data();
+    const float* __restrict vy = velocitiesY.data();
+    const float* __restrict vz = velocitiesZ.data();
+    float* __restrict life = lifetimes.data();
+
+    for (size_t i = 0; i < n; ++i) x[i] += vx[i] * deltaTime;
+    for (size_t i = 0; i < n; ++i) y[i] += vy[i] * deltaTime;
+    for (size_t i = 0; i < n; ++i) z[i] += vz[i] * deltaTime;
+    for (size_t i = 0; i < n; ++i) life[i] -= deltaTime;
+}
+
+void ProjectileSystem::update(float deltaTime, const SpatialHashGrid& grid, const EntityStorage& storage,
+                              const NavGrid* navGrid, std::vector<Hit>& hits) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        adding.swap(queued);
+    }
+    std::sort(adding.begin(), adding.end(), [](const QueuedShot& a, const QueuedShot& b) {
+        return a.order != b.order ? a.order < b.order : a.sequence < b.sequence;
+    });
+    for (const QueuedShot& queuedShot : adding) {
+        add(queuedShot.shot);
+    }
+    adding.clear();
+
+    integrate(deltaTime);
+
+    const bool checkGrid = navGrid && navGrid->hasObstacles();
+    const bool checkMobs = grid.getMobCount() > 0;
+    const float maxMobRadius = grid.getMaxRadius();
+    const std::vector<glm::vec3>& mobPositions = storage.positions;
+    const std::vector<float>& mobRadii = storage.radii;
+    const std::vector<EntityKind>& mobKinds = storage.kinds;
+
+    // Swap-removal moves an already integrated projectile into slot i, so i
+    // only advances past survivors. A projectile's last step is still tested
+    // for hits before it expires.
+    size_t i = 0;
+    while (i < count) {
+        const float x = positionsX[i];
+        const float z = positionsZ[i];
+        const float motionX = velocitiesX[i] * deltaTime;
+        const float motionZ = velocitiesZ[i] * deltaTime;
+        const float fromX = x - motionX;
+        const float fromZ = z - motionZ;
+
+        if (checkMobs) {
+            // This tick's step, swept against every mob bucketed around it
+            const float reach = radii[i] + maxMobRadius;
+            const float radius = radii[i];
+            const EntityKind ownerKind = ownerKinds[i];
+
+            float bestTime = 2.0f;
+            uint32_t bestSlot = 0;
+            grid.forEachInBox(std::min(fromX, x) - reach, std::min(fromZ, z) - reach, std::max(fromX, x) + reach,
+                              std::max(fromZ, z) + reach, [&](uint32_t slot) {
+                                  if (mobKinds[slot] == ownerKind) return;
+                                  const glm::vec3& center = mobPositions[slot];
+                                  float t = stepTimeOfImpact(fromX - center.x, fromZ - center.z, motionX, motionZ,
+                                                             radius + mobRadii[slot]);
+                                  if (t >= 0.0f && (t < bestTime || (t == bestTime && slot < bestSlot))) {
+                                      bestTime = t;
+                                      bestSlot = slot;
+                                  }
+                              });
+
+            if (bestTime <= 1.0f) {
+                const glm::vec3 contact(fromX + motionX * bestTime, positionsY[i], fromZ + motionZ * bestTime);
+                // A wall crossed on the way to the mob stops the projectile first
+                if (checkGrid && !navGrid->lineOfSight(glm::vec3(fromX, 0.0f, fromZ), contact)) {
+                    stats.blocked++;
+                } else {
+                    hits.push_back({bestSlot, owners[i], damages[i], contact});
+                    stats.hits++;
+                }
+                removeAt(i);
+                continue;
+            }
+        }
+
+        // Walk every cell of the step, so fast projectiles cannot skip a thin wall
+        if (checkGrid && !navGrid->lineOfSight(glm::vec3(fromX, 0.0f, fromZ), glm::vec3(x, 0.0f, z))) {
+            stats.blocked++;
+            removeAt(i);
+            continue;
+        }
+
+        if (lifetimes[i] <= 0.0f) {
+            stats.expired++;
+            removeAt(i);
+            continue;
+        }
+
+        ++i;
+    }
+}
@@ -272,13 +272,21 @@ void Renderer::renderCircle(const glm::vec3& position, float radius, const glm::
     glBindVertexArray(0);
 }
 
-void Renderer::renderEntities(const EntityManager& entityManager) {
+void Renderer::renderEntities(const EntityManager& entityManager, float alpha) {
     for (const auto& entity : entityManager.getEntities()) {
-        if (entity && entity->active) {
+        if (entity->isActive()) {
             // For now, render all entities as circles
-            renderCircle(entity->position, 0.5f, entity->color);
+            renderCircle(entity->getInterpolatedPosition(alpha), 0.5f, entity->color);
         }
     }
+
+    // Projectiles as small circles at their latest positions
+    const ProjectileSystem& projectiles = entityManager.getProjectiles();
+    const glm::vec3 projectileColor(1.0f, 0.9f, 0.3f);
+    for (size_t i = 0; i < projectiles.getCount(); ++i) {
+        glm::vec3 position(projectiles.getPositionsX()[i], projectiles.getPositionsY()[i], projectiles.getPositionsZ()[i]);
+        renderCircle(position, projectiles.getRadii()[i], projectileColor, 8);
+    }
 }
 
 bool Renderer::shouldClose() const {
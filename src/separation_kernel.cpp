@@ -0,0 +1,222 @@
+#include "separation_kernel.h"
+#include <cmath>
+
+#if defined(ACTIONRPG_HAS_X86_KERNELS)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// Preferred spacing is the sum of radii plus this buffer factor
+static constexpr float SEPARATION_BUFFER = 1.2f;
+// Coincident mobs have no usable push direction
+static constexpr float MIN_SEPARATION_DISTANCE = 0.001f;
+
+SeparationResult separationKernelScalar(const glm::vec3& position, float radius,
+                                        const float* xs, const float* ys, const float* zs,
+                                        const float* radii, size_t count) {
+    SeparationResult result;
+
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 toOther(position.x - xs[i], position.y - ys[i], position.z - zs[i]);
+        float distance = std::sqrt(glm::dot(toOther, toOther));
+        float preferredDistance = (radius + radii[i]) * SEPARATION_BUFFER;
+
+        // Apply gentle separation force when entities are too close
+        if (distance < preferredDistance && distance > MIN_SEPARATION_DISTANCE) {
+            float strength = (preferredDistance - distance) / preferredDistance;
+            result.force += toOther * (strength / distance);
+            result.count++;
+        }
+    }
+
+    return result;
+}
+
+#if defined(ACTIONRPG_HAS_X86_KERNELS)
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define ACTIONRPG_TARGET_SSE2
+#define ACTIONRPG_TARGET_AVX2
+#else
+#define ACTIONRPG_TARGET_SSE2 __attribute__((target("sse2")))
+#define ACTIONRPG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+ACTIONRPG_TARGET_SSE2
+static float horizontalSum(__m128 v) {
+    __m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sums);
+    sums = _mm_add_ss(sums, shuffled);
+    return _mm_cvtss_f32(sums);
+}
+
+ACTIONRPG_TARGET_SSE2
+SeparationResult separationKernelSSE(const glm::vec3& position, float radius,
+                                     const float* xs, const float* ys, const float* zs,
+                                     const float* radii, size_t count) {
+    const __m128 selfX = _mm_set1_ps(position.x);
+    const __m128 selfY = _mm_set1_ps(position.y);
+    const __m128 selfZ = _mm_set1_ps(position.z);
+    const __m128 selfRadius = _mm_set1_ps(radius);
+    const __m128 buffer = _mm_set1_ps(SEPARATION_BUFFER);
+    const __m128 minDistance = _mm_set1_ps(MIN_SEPARATION_DISTANCE);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    __m128 forceX = _mm_setzero_ps();
+    __m128 forceY = _mm_setzero_ps();
+    __m128 forceZ = _mm_setzero_ps();
+    __m128 hits = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(selfX, _mm_loadu_ps(xs + i));
+        __m128 dy = _mm_sub_ps(selfY, _mm_loadu_ps(ys + i));
+        __m128 dz = _mm_sub_ps(selfZ, _mm_loadu_ps(zs + i));
+
+        __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        __m128 distance = _mm_sqrt_ps(distanceSq);
+        __m128 preferred = _mm_mul_ps(_mm_add_ps(selfRadius, _mm_loadu_ps(radii + i)), buffer);
+
+        __m128 mask = _mm_and_ps(_mm_cmplt_ps(distance, preferred), _mm_cmpgt_ps(distance, minDistance));
+
+        // Masked-off lanes (including coincident ones dividing by zero) contribute nothing
+        __m128 strength = _mm_div_ps(_mm_sub_ps(preferred, distance), preferred);
+        __m128 scale = _mm_and_ps(mask, _mm_div_ps(strength, distance));
+
+        forceX = _mm_add_ps(forceX, _mm_mul_ps(dx, scale));
+        forceY = _mm_add_ps(forceY, _mm_mul_ps(dy, scale));
+        forceZ = _mm_add_ps(forceZ, _mm_mul_ps(dz, scale));
+        hits = _mm_add_ps(hits, _mm_and_ps(mask, one));
+    }
+
+    SeparationResult result = separationKernelScalar(position, radius, xs + i, ys + i, zs + i, radii + i, count - i);
+    result.force += glm::vec3(horizontalSum(forceX), horizontalSum(forceY), horizontalSum(forceZ));
+    result.count += static_cast<int>(horizontalSum(hits));
+    return result;
+}
+
+ACTIONRPG_TARGET_AVX2
+static float horizontalSum(__m256 v) {
+    __m128 low = _mm256_castps256_ps128(v);
+    __m128 high = _mm256_extractf128_ps(v, 1);
+    __m128 sums = _mm_add_ps(low, high);
+    __m128 shuffled = _mm_movehdup_ps(sums);
+    sums = _mm_add_ps(sums, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sums);
+    sums = _mm_add_ss(sums, shuffled);
+    return _mm_cvtss_f32(sums);
+}
+
+ACTIONRPG_TARGET_AVX2
+SeparationResult separationKernelAVX2(const glm::vec3& position, float radius,
+                                      const float* xs, const float* ys, const float* zs,
+                                      const float* radii, size_t count) {
+    const __m256 selfX = _mm256_set1_ps(position.x);
+    const __m256 selfY = _mm256_set1_ps(position.y);
+    const __m256 selfZ = _mm256_set1_ps(position.z);
+    const __m256 selfRadius = _mm256_set1_ps(radius);
+    const __m256 buffer = _mm256_set1_ps(SEPARATION_BUFFER);
+    const __m256 minDistance = _mm256_set1_ps(MIN_SEPARATION_DISTANCE);
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    __m256 forceX = _mm256_setzero_ps();
+    __m256 forceY = _mm256_setzero_ps();
+    __m256 forceZ = _mm256_setzero_ps();
+    __m256 hits = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(selfX, _mm256_loadu_ps(xs + i));
+        __m256 dy = _mm256_sub_ps(selfY, _mm256_loadu_ps(ys + i));
+        __m256 dz = _mm256_sub_ps(selfZ, _mm256_loadu_ps(zs + i));
+
+        __m256 distanceSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+        __m256 distance = _mm256_sqrt_ps(distanceSq);
+        __m256 preferred = _mm256_mul_ps(_mm256_add_ps(selfRadius, _mm256_loadu_ps(radii + i)), buffer);
+
+        __m256 mask = _mm256_and_ps(_mm256_cmp_ps(distance, preferred, _CMP_LT_OQ),
+                                    _mm256_cmp_ps(distance, minDistance, _CMP_GT_OQ));
+
+        // Masked-off lanes (including coincident ones dividing by zero) contribute nothing
+        __m256 strength = _mm256_div_ps(_mm256_sub_ps(preferred, distance), preferred);
+        __m256 scale = _mm256_and_ps(mask, _mm256_div_ps(strength, distance));
+
+        forceX = _mm256_add_ps(forceX, _mm256_mul_ps(dx, scale));
+        forceY = _mm256_add_ps(forceY, _mm256_mul_ps(dy, scale));
+        forceZ = _mm256_add_ps(forceZ, _mm256_mul_ps(dz, scale));
+        hits = _mm256_add_ps(hits, _mm256_and_ps(mask, one));
+    }
+
+    // Finish the remainder 4-wide, then scalar
+    SeparationResult result = separationKernelSSE(position, radius, xs + i, ys + i, zs + i, radii + i, count - i);
+    result.force += glm::vec3(horizontalSum(forceX), horizontalSum(forceY), horizontalSum(forceZ));
+    result.count += static_cast<int>(horizontalSum(hits));
+    return result;
+}
+
+bool cpuSupportsSSE2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+bool cpuSupportsAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    // The OS must also save the YMM registers on context switches
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // ACTIONRPG_HAS_X86_KERNELS
+
+namespace {
+
+struct KernelChoice {
+    SeparationKernel kernel;
+    const char* name;
+};
+
+KernelChoice detectKernel() {
+#if defined(ACTIONRPG_HAS_X86_KERNELS)
+    if (cpuSupportsAVX2()) {
+        return {separationKernelAVX2, "avx2"};
+    }
+    if (cpuSupportsSSE2()) {
+        return {separationKernelSSE, "sse2"};
+    }
+#endif
+    return {separationKernelScalar, "scalar"};
+}
+
+const KernelChoice& selectedKernel() {
+    static const KernelChoice choice = detectKernel();
+    return choice;
+}
+
+} // namespace
+
+SeparationKernel getSeparationKernel() {
+    return selectedKernel().kernel;
+}
+
+const char* getSeparationKernelName() {
+    return selectedKernel().name;
+}
@@ -0,0 +1,97 @@
+#include "simulation.h"
+#include "input_record.h"
+
+Simulation::Simulation(UpdateMode mode, size_t workerThreads, uint64_t seed)
+    : entityManager(std::make_unique<EntityManager>())
+    , tickCount(0)
+    , seed(seed)
+    , rng(seed)
+    , recorder(nullptr)
+{
+    entityManager->setUpdateMode(mode, workerThreads);
+}
+
+void Simulation::createParty() {
+    // Character 1 - Red
+    auto player1 = entityManager->spawn<PlayerEntity>();
+    player1->setPosition(glm::vec3(0.0f, 0.0f, 0.0f));
+    player1->color = glm::vec3(0.9f, 0.2f, 0.2f); // Red
+    party.push_back(player1);
+
+    // Character 2 - Green
+    auto player2 = entityManager->spawn<PlayerEntity>();
+    player2->setPosition(glm::vec3(2.0f, 0.0f, 0.0f));
+    player2->color = glm::vec3(0.2f, 0.9f, 0.2f); // Green
+    party.push_back(player2);
+
+    // Character 3 - Blue
+    auto player3 = entityManager->spawn<PlayerEntity>();
+    player3->setPosition(glm::vec3(-2.0f, 0.0f, 0.0f));
+    player3->color = glm::vec3(0.2f, 0.2f, 0.9f); // Blue
+    party.push_back(player3);
+}
+
+std::shared_ptr<BasicShooterEnemy> Simulation::spawnEnemy(const glm::vec3& position) {
+    auto enemy = entityManager->spawn<BasicShooterEnemy>();
+    enemy->setPosition(position);
+    enemy->color = glm::vec3(0.9f, 0.5f, 0.1f); // Orange color for enemies
+    enemy->stats.setBase(Stat::MovementSpeed, 3.0f); // Slower than default player speed
+    return enemy;
+}
+
+bool Simulation::saveSnapshot(const std::string& path) const {
+    return entityManager->saveSnapshot(path);
+}
+
+bool Simulation::loadSnapshot(const std::string& path) {
+    if (!entityManager->loadSnapshot(path)) {
+        return false;
+    }
+
+    // Party order is the order the PCs were added, as on save
+    party.clear();
+    for (EntityHandle handle : entityManager->getPlayerHandles()) {
+        uint32_t slot;
+        if (entityManager->tryGetSlot(handle, slot)) {
+            party.push_back(std::static_pointer_cast<PlayerEntity>(entityManager->getEntities()[slot]));
+        }
+    }
+    pendingCommands.clear();
+    return true;
+}
+
+void Simulation::applyCommand(const SimCommand& command) {
+    switch (command.type) {
+        case SimCommand::Type::MoveTo:
+            if (command.partyIndex < party.size()) {
+                party[command.partyIndex]->moveTo(command.target);
+            }
+            break;
+        case SimCommand::Type::Stop:
+            if (command.partyIndex < party.size()) {
+                party[command.partyIndex]->stop();
+            }
+            break;
+        case SimCommand::Type::SpawnEnemy: {
+            // Draw the coordinates in a fixed order so replays match
+            std::uniform_real_distribution<float> dis(-15.0f, 15.0f);
+            float x = dis(rng);
+            float z = dis(rng);
+            spawnEnemy(glm::vec3(x, 0.0f, z));
+            break;
+        }
+    }
+}
+
+void Simulation::step(float deltaTime) {
+    if (recorder && !pendingCommands.empty()) {
+        recorder->record(tickCount, pendingCommands);
+    }
+    for (const SimCommand& command : pendingCommands) {
+        applyCommand(command);
+    }
+    pendingCommands.clear();
+
+    entityManager->updateAll(deltaTime);
+    tickCount++;
+}
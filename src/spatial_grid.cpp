@@ -0,0 +1,435 @@
+#include "spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+SpatialHashGrid::SpatialHashGrid(float cellSize)
+    : source(nullptr)
+    , cellSize(cellSize)
+    , inverseCellSize(1.0f / cellSize)
+    , maxRadius(0.0f)
+    , occupiedMinX(0)
+    , occupiedMinZ(0)
+    , occupiedMaxX(0)
+    , occupiedMaxZ(0)
+    , bucketMask(0)
+    , disturbRing(1)
+{
+}
+
+void SpatialHashGrid::clear() {
+    bucketStart.clear();
+    cellEntries.clear();
+    bucketDisturbed.clear();
+    maxRadius = 0.0f;
+    bucketMask = 0;
+    source = nullptr;
+}
+
+void SpatialHashGrid::rebuild(const EntityStorage& storage) {
+    source = &storage;
+    scratchEntries.clear();
+    maxRadius = 0.0f;
+    occupiedMinX = occupiedMinZ = std::numeric_limits<int32_t>::max();
+    occupiedMaxX = occupiedMaxZ = std::numeric_limits<int32_t>::min();
+
+    const uint32_t count = storage.size();
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        if (!storage.active[slot] || !isMobKind(storage.kinds[slot])) continue;
+
+        const glm::vec3& position = storage.positions[slot];
+        CellEntry entry{slot, cellCoord(position.x), cellCoord(position.z)};
+        scratchEntries.push_back(entry);
+        maxRadius = std::max(maxRadius, storage.radii[slot]);
+        occupiedMinX = std::min(occupiedMinX, entry.cellX);
+        occupiedMaxX = std::max(occupiedMaxX, entry.cellX);
+        occupiedMinZ = std::min(occupiedMinZ, entry.cellZ);
+        occupiedMaxZ = std::max(occupiedMaxZ, entry.cellZ);
+    }
+
+    // Keep the table at least twice the mob count to keep buckets short
+    uint32_t bucketCount = 64;
+    while (bucketCount < scratchEntries.size() * 2) {
+        bucketCount <<= 1;
+    }
+    bucketMask = bucketCount - 1;
+
+    // Counting sort of entries into buckets
+    bucketStart.assign(bucketCount + 1, 0);
+    bucketDisturbed.assign(bucketCount, 0);
+    for (const auto& entry : scratchEntries) {
+        uint32_t bucket = bucketIndex(entry.cellX, entry.cellZ);
+        bucketStart[bucket + 1]++;
+        if (storage.stillTicks[entry.slot] == 0) {
+            bucketDisturbed[bucket] = 1;
+        }
+    }
+    for (uint32_t b = 0; b < bucketCount; ++b) {
+        bucketStart[b + 1] += bucketStart[b];
+    }
+
+    cellEntries.resize(scratchEntries.size());
+    std::vector<uint32_t>& cursor = bucketStart;
+    for (const auto& entry : scratchEntries) {
+        // Fill using the start offsets, then shift them back afterwards
+        cellEntries[cursor[bucketIndex(entry.cellX, entry.cellZ)]++] = entry;
+    }
+    for (uint32_t b = bucketCount; b > 0; --b) {
+        bucketStart[b] = bucketStart[b - 1];
+    }
+    bucketStart[0] = 0;
+
+    // Separation reaches (r1 + r2) * 1.2; cover it with whole cells
+    disturbRing = std::max(1, static_cast<int32_t>(std::ceil(maxRadius * 2.4f * inverseCellSize)));
+}
+
+namespace {
+
+// Time in [0, 1] at which a circle moving by motion from offset (center minus
+// obstacle, XZ only) first comes within reach of the obstacle, or -1 for none
+float circleTimeOfImpact(const glm::vec2& offset, const glm::vec2& motion, float reach) {
+    float c = glm::dot(offset, offset) - reach * reach;
+    float b = glm::dot(offset, motion);
+
+    // Already touching: a hit only if heading further in
+    if (c <= 0.0f) {
+        return b < 0.0f ? 0.0f : -1.0f;
+    }
+
+    float a = glm::dot(motion, motion);
+    if (b >= 0.0f || a <= 0.0f) return -1.0f; // Moving away or not moving
+
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) return -1.0f;
+
+    float t = (-b - std::sqrt(discriminant)) / a;
+    return t <= 1.0f ? t : -1.0f;
+}
+
+} // namespace
+
+bool SpatialHashGrid::sweepCircle(const glm::vec3& start, const glm::vec3& end, float radius, uint32_t ignoreSlot,
+                                  SweepHit& hit) const {
+    if (cellEntries.empty()) return false;
+
+    const std::vector<glm::vec3>& positions = source->positions;
+    const std::vector<float>& radii = source->radii;
+
+    glm::vec2 from(start.x, start.z);
+    glm::vec2 motion(end.x - start.x, end.z - start.z);
+    float bestTime = std::numeric_limits<float>::max();
+    uint32_t bestSlot = 0;
+
+    auto test = [&](uint32_t slot) {
+        if (slot == ignoreSlot) return;
+
+        const glm::vec3& other = positions[slot];
+        float t = circleTimeOfImpact(from - glm::vec2(other.x, other.z), motion, radius + radii[slot]);
+        if (t >= 0.0f && t < bestTime) {
+            bestTime = t;
+            bestSlot = slot;
+        }
+    };
+
+    // Cells overlapping the swept circle's bounds, grown by the largest mob radius
+    float reach = radius + maxRadius;
+    int32_t minX = cellCoord(std::min(start.x, end.x) - reach);
+    int32_t maxX = cellCoord(std::max(start.x, end.x) + reach);
+    int32_t minZ = cellCoord(std::min(start.z, end.z) - reach);
+    int32_t maxZ = cellCoord(std::max(start.z, end.z) + reach);
+
+    int64_t cellSpan = static_cast<int64_t>(maxX - minX + 1) * static_cast<int64_t>(maxZ - minZ + 1);
+    if (cellSpan > static_cast<int64_t>(bucketMask) + 1) {
+        for (const CellEntry& entry : cellEntries) {
+            test(entry.slot);
+        }
+    } else {
+        for (int32_t cz = minZ; cz <= maxZ; ++cz) {
+            for (int32_t cx = minX; cx <= maxX; ++cx) {
+                uint32_t bucket = bucketIndex(cx, cz);
+                for (uint32_t i = bucketStart[bucket]; i < bucketStart[bucket + 1]; ++i) {
+                    const CellEntry& entry = cellEntries[i];
+                    if (entry.cellX != cx || entry.cellZ != cz) continue;
+                    test(entry.slot);
+                }
+            }
+        }
+    }
+
+    if (bestTime > 1.0f) return false;
+
+    // Contact normal from the hit mob's center to the circle at impact
+    const glm::vec3& other = positions[bestSlot];
+    glm::vec2 contact = from + motion * bestTime - glm::vec2(other.x, other.z);
+    float length = glm::length(contact);
+    glm::vec2 normal = length > 0.0001f ? contact / length : glm::vec2(-motion.x, -motion.y);
+    float normalLength = glm::length(normal);
+    if (normalLength > 0.0f) normal /= normalLength;
+
+    hit.slot = bestSlot;
+    hit.time = bestTime;
+    hit.normal = glm::vec3(normal.x, 0.0f, normal.y);
+    return true;
+}
+
+bool SpatialHashGrid::isNeighborhoodDisturbed(const glm::vec3& position) const {
+    if (bucketDisturbed.empty()) return false;
+
+    int32_t cellX = cellCoord(position.x);
+    int32_t cellZ = cellCoord(position.z);
+    for (int32_t cz = cellZ - disturbRing; cz <= cellZ + disturbRing; ++cz) {
+        for (int32_t cx = cellX - disturbRing; cx <= cellX + disturbRing; ++cx) {
+            if (bucketDisturbed[bucketIndex(cx, cz)]) return true;
+        }
+    }
+    return false;
+}
+
+void SpatialHashGrid::queryRadius(const glm::vec3& position, float radius, std::vector<uint32_t>& results) const {
+    results.clear();
+    if (cellEntries.empty()) return;
+
+    const std::vector<glm::vec3>& positions = source->positions;
+
+    int32_t minX = cellCoord(position.x - radius);
+    int32_t maxX = cellCoord(position.x + radius);
+    int32_t minZ = cellCoord(position.z - radius);
+    int32_t maxZ = cellCoord(position.z + radius);
+    float radiusSq = radius * radius;
+
+    // Huge queries touch more cells than there are buckets; scan everything instead
+    int64_t cellSpan = static_cast<int64_t>(maxX - minX + 1) * static_cast<int64_t>(maxZ - minZ + 1);
+    if (cellSpan > static_cast<int64_t>(bucketMask) + 1) {
+        for (const CellEntry& entry : cellEntries) {
+            glm::vec3 offset = positions[entry.slot] - position;
+            if (glm::dot(offset, offset) <= radiusSq) {
+                results.push_back(entry.slot);
+            }
+        }
+        return;
+    }
+
+    for (int32_t cz = minZ; cz <= maxZ; ++cz) {
+        for (int32_t cx = minX; cx <= maxX; ++cx) {
+            uint32_t bucket = bucketIndex(cx, cz);
+            for (uint32_t i = bucketStart[bucket]; i < bucketStart[bucket + 1]; ++i) {
+                const CellEntry& entry = cellEntries[i];
+
+                // Skip other cells that hashed into the same bucket
+                if (entry.cellX != cx || entry.cellZ != cz) continue;
+
+                glm::vec3 offset = positions[entry.slot] - position;
+                if (glm::dot(offset, offset) <= radiusSq) {
+                    results.push_back(entry.slot);
+                }
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::queryRadius(const glm::vec3& position, float radius, EntityKindMask kinds,
+                                  std::vector<uint32_t>& results) const {
+    results.clear();
+    if (cellEntries.empty()) return;
+
+    const std::vector<glm::vec3>& positions = source->positions;
+    const std::vector<EntityKind>& entityKinds = source->kinds;
+    const float radiusSq = radius * radius;
+
+    forEachInBox(position.x - radius, position.z - radius, position.x + radius, position.z + radius,
+                 [&](uint32_t slot) {
+                     if (!(kinds & kindMask(entityKinds[slot]))) return;
+                     glm::vec3 offset = positions[slot] - position;
+                     if (glm::dot(offset, offset) <= radiusSq) {
+                         results.push_back(slot);
+                     }
+                 });
+}
+
+void SpatialHashGrid::queryKNearest(const glm::vec3& position, size_t k, float maxDistance, EntityKindMask kinds,
+                                    std::vector<uint32_t>& results) const {
+    results.clear();
+    if (cellEntries.empty() || k == 0) return;
+
+    const std::vector<glm::vec3>& positions = source->positions;
+    const std::vector<EntityKind>& entityKinds = source->kinds;
+    const float maxDistanceSq = maxDistance * maxDistance;
+
+    // Max-heap of the best k so far on (distance squared, slot)
+    thread_local std::vector<std::pair<float, uint32_t>> nearest;
+    nearest.clear();
+
+    auto consider = [&](uint32_t slot) {
+        if (!(kinds & kindMask(entityKinds[slot]))) return;
+
+        glm::vec3 offset = positions[slot] - position;
+        std::pair<float, uint32_t> candidate(glm::dot(offset, offset), slot);
+        if (candidate.first > maxDistanceSq) return;
+
+        if (nearest.size() < k) {
+            nearest.push_back(candidate);
+            std::push_heap(nearest.begin(), nearest.end());
+        } else if (candidate < nearest.front()) {
+            std::pop_heap(nearest.begin(), nearest.end());
+            nearest.back() = candidate;
+            std::push_heap(nearest.begin(), nearest.end());
+        }
+    };
+
+    const int32_t cellX = cellCoord(position.x);
+    const int32_t cellZ = cellCoord(position.z);
+
+    // How far the position is from the nearest edge of its own cell; ring r
+    // (cells r steps away) is at least (r - 1) cells plus this gap away
+    const float cellMinX = cellX * cellSize;
+    const float cellMinZ = cellZ * cellSize;
+    const float edgeGap = std::max(0.0f, std::min(std::min(position.x - cellMinX, cellMinX + cellSize - position.x),
+                                                  std::min(position.z - cellMinZ, cellMinZ + cellSize - position.z)));
+
+    const int64_t bucketCount = static_cast<int64_t>(bucketMask) + 1;
+    for (int32_t ring = 0;; ++ring) {
+        float ringDistance = ring == 0 ? 0.0f : (ring - 1) * cellSize + edgeGap;
+        float ringDistanceSq = ringDistance * ringDistance;
+        if (ringDistanceSq > maxDistanceSq) break;
+        if (nearest.size() == k && ringDistanceSq > nearest.front().first) break;
+
+        // Searched further out than the table is large: scan everything instead
+        int64_t side = 2 * static_cast<int64_t>(ring) + 1;
+        if (side * side > bucketCount) {
+            nearest.clear();
+            for (const CellEntry& entry : cellEntries) {
+                consider(entry.slot);
+            }
+            break;
+        }
+
+        for (int32_t cz = cellZ - ring; cz <= cellZ + ring; ++cz) {
+            // Inner rows only contribute the two cells on the ring's sides
+            const bool edgeRow = cz == cellZ - ring || cz == cellZ + ring;
+            const int32_t step = edgeRow || ring == 0 ? 1 : 2 * ring;
+            for (int32_t cx = cellX - ring; cx <= cellX + ring; cx += step) {
+                uint32_t bucket = bucketIndex(cx, cz);
+                for (uint32_t i = bucketStart[bucket]; i < bucketStart[bucket + 1]; ++i) {
+                    const CellEntry& entry = cellEntries[i];
+                    if (entry.cellX == cx && entry.cellZ == cz) {
+                        consider(entry.slot);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort_heap(nearest.begin(), nearest.end());
+    for (const auto& candidate : nearest) {
+        results.push_back(candidate.second);
+    }
+}
+
+void SpatialHashGrid::queryAABB(const glm::vec3& minCorner, const glm::vec3& maxCorner, EntityKindMask kinds,
+                                std::vector<uint32_t>& results) const {
+    results.clear();
+    if (cellEntries.empty()) return;
+
+    const std::vector<glm::vec3>& positions = source->positions;
+    const std::vector<EntityKind>& entityKinds = source->kinds;
+
+    forEachInBox(minCorner.x, minCorner.z, maxCorner.x, maxCorner.z, [&](uint32_t slot) {
+        if (!(kinds & kindMask(entityKinds[slot]))) return;
+        const glm::vec3& p = positions[slot];
+        if (p.x >= minCorner.x && p.x <= maxCorner.x && p.z >= minCorner.z && p.z <= maxCorner.z) {
+            results.push_back(slot);
+        }
+    });
+}
+
+bool SpatialHashGrid::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                              EntityKindMask kinds, uint32_t ignoreSlot, RayHit& hit) const {
+    if (cellEntries.empty() || maxDistance < 0.0f) return false;
+
+    glm::vec2 unit(direction.x, direction.z);
+    float length = glm::length(unit);
+    if (length <= 0.0f) return false;
+    unit /= length;
+
+    const std::vector<glm::vec3>& positions = source->positions;
+    const std::vector<float>& radii = source->radii;
+    const std::vector<EntityKind>& entityKinds = source->kinds;
+    const glm::vec2 from(origin.x, origin.z);
+
+    float bestDistance = std::numeric_limits<float>::max();
+    uint32_t bestSlot = 0;
+
+    auto test = [&](uint32_t slot) {
+        if (slot == ignoreSlot || !(kinds & kindMask(entityKinds[slot]))) return;
+
+        // Entry distance along the unit ray into the mob's circle
+        const glm::vec3& center = positions[slot];
+        glm::vec2 offset = from - glm::vec2(center.x, center.z);
+        float reach = radii[slot];
+        float c = glm::dot(offset, offset) - reach * reach;
+        float distance;
+        if (c <= 0.0f) {
+            distance = 0.0f;
+        } else {
+            float b = glm::dot(offset, unit);
+            if (b >= 0.0f) return;
+            float discriminant = b * b - c;
+            if (discriminant < 0.0f) return;
+            distance = -b - std::sqrt(discriminant);
+        }
+
+        if (distance <= maxDistance && (distance < bestDistance || (distance == bestDistance && slot < bestSlot))) {
+            bestDistance = distance;
+            bestSlot = slot;
+        }
+    };
+
+    // Only the stretch of ray over occupied cells (grown by the largest mob
+    // radius) can hit anything
+    float enter = 0.0f;
+    float exit = maxDistance;
+    for (int axis = 0; axis < 2; ++axis) {
+        float low = (axis == 0 ? occupiedMinX : occupiedMinZ) * cellSize - maxRadius;
+        float high = ((axis == 0 ? occupiedMaxX : occupiedMaxZ) + 1) * cellSize + maxRadius;
+        float p = from[axis];
+        float u = unit[axis];
+        if (u == 0.0f) {
+            if (p < low || p > high) return false;
+            continue;
+        }
+        float t1 = (low - p) / u;
+        float t2 = (high - p) / u;
+        enter = std::max(enter, std::min(t1, t2));
+        exit = std::min(exit, std::max(t1, t2));
+    }
+    if (enter > exit) return false;
+
+    // Walk the ray a few cells at a time, each stretch's bounds grown by the
+    // largest mob radius. A mob the ray enters within a stretch is bucketed in
+    // that stretch's box, so once the best hit lies behind the stretch's end
+    // nothing further along can beat it.
+    const float stretch = cellSize * 4.0f;
+    for (float start = enter; start <= exit; start += stretch) {
+        float end = std::min(start + stretch, exit);
+        glm::vec2 a = from + unit * start;
+        glm::vec2 b = from + unit * end;
+        forEachInBox(std::min(a.x, b.x) - maxRadius, std::min(a.y, b.y) - maxRadius, std::max(a.x, b.x) + maxRadius,
+                     std::max(a.y, b.y) + maxRadius, test);
+        if (bestDistance <= end) break;
+    }
+
+    if (bestDistance > maxDistance) return false;
+
+    const glm::vec3& center = positions[bestSlot];
+    glm::vec2 point = from + unit * bestDistance;
+    glm::vec2 contact = point - glm::vec2(center.x, center.z);
+    float contactLength = glm::length(contact);
+    glm::vec2 normal = contactLength > 0.0001f ? contact / contactLength : -unit;
+
+    hit.slot = bestSlot;
+    hit.distance = bestDistance;
+    hit.point = glm::vec3(point.x, origin.y, point.y);
+    hit.normal = glm::vec3(normal.x, 0.0f, normal.y);
+    return true;
+}
@@ -0,0 +1,87 @@
+#include "stat_block.h"
+#include <algorithm>
+
+namespace {
+
+uint32_t statBit(Stat stat) {
+    return 1u << static_cast<uint32_t>(stat);
+}
+
+} // namespace
+
+StatBlock::StatBlock()
+    : base{100.0f, 100.0f, 5.0f, 1.0f}
+    , derived{}
+    , version(0)
+{
+    recompute((1u << STAT_COUNT) - 1);
+}
+
+void StatBlock::setBase(Stat stat, float value) {
+    base[static_cast<size_t>(stat)] = value;
+    recompute(statBit(stat));
+}
+
+void StatBlock::addModifier(const StatModifier& modifier) {
+    modifiers.push_back(modifier);
+    recompute(statBit(modifier.stat));
+}
+
+size_t StatBlock::removeModifiers(uint32_t source) {
+    uint32_t touched = 0;
+    auto kept = std::remove_if(modifiers.begin(), modifiers.end(), [&](const StatModifier& modifier) {
+        if (modifier.source != source) return false;
+        touched |= statBit(modifier.stat);
+        return true;
+    });
+    size_t removed = static_cast<size_t>(modifiers.end() - kept);
+    modifiers.erase(kept, modifiers.end());
+
+    if (touched) {
+        recompute(touched);
+    }
+    return removed;
+}
+
+void StatBlock::clearModifiers() {
+    uint32_t touched = 0;
+    for (const StatModifier& modifier : modifiers) {
+        touched |= statBit(modifier.stat);
+    }
+    modifiers.clear();
+
+    if (touched) {
+        recompute(touched);
+    }
+}
+
+void StatBlock::recompute(uint32_t statMask) {
+    float flat[STAT_COUNT] = {};
+    float increased[STAT_COUNT] = {};
+    float more[STAT_COUNT];
+    std::fill(more, more + STAT_COUNT, 1.0f);
+
+    // One pass over the stack for every stat being refreshed
+    for (const StatModifier& modifier : modifiers) {
+        if (!(statMask & statBit(modifier.stat))) continue;
+
+        const size_t i = static_cast<size_t>(modifier.stat);
+        switch (modifier.kind) {
+            case ModifierKind::Flat:
+                flat[i] += modifier.value;
+                break;
+            case ModifierKind::Increased:
+                increased[i] += modifier.value;
+                break;
+            case ModifierKind::More:
+                more[i] *= 1.0f + modifier.value;
+                break;
+        }
+    }
+
+    for (size_t i = 0; i < STAT_COUNT; ++i) {
+        if (!(statMask & (1u << i))) continue;
+        derived[i] = std::max(0.0f, (base[i] + flat[i]) * (1.0f + increased[i]) * more[i]);
+    }
+    version++;
+}
@@ -0,0 +1,90 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t workerCount)
+    : job(nullptr)
+    , jobCount(0)
+    , jobChunkSize(1)
+    , nextChunk(0)
+    , busyWorkers(0)
+    , jobGeneration(0)
+    , stopping(false)
+{
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+
+    chunkSize = std::max<size_t>(chunkSize, 1);
+
+    // Not worth waking anyone for a single chunk
+    if (workers.empty() || count <= chunkSize) {
+        fn(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobCount = count;
+        jobChunkSize = chunkSize;
+        nextChunk.store(0, std::memory_order_relaxed);
+        busyWorkers = workers.size();
+        jobGeneration++;
+    }
+    wakeCondition.notify_all();
+
+    // The caller works too instead of idling
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return busyWorkers == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::runChunks() {
+    for (;;) {
+        size_t begin = nextChunk.fetch_add(jobChunkSize, std::memory_order_relaxed);
+        if (begin >= jobCount) break;
+
+        size_t end = std::min(begin + jobChunkSize, jobCount);
+        (*job)(begin, end);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    uint64_t seenGeneration = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = jobGeneration;
+        }
+
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        doneCondition.notify_one();
+    }
+}
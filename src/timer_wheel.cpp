@@ -0,0 +1,178 @@
+#include "timer_wheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel()
+    : freeHead(NONE)
+    , now(0)
+    , pendingCount(0)
+{
+    std::fill(std::begin(heads), std::end(heads), NONE);
+    std::fill(std::begin(tails), std::end(tails), NONE);
+}
+
+TimerHandle TimerWheel::schedule(uint32_t delay, EntityHandle entity, uint32_t tag, uint32_t data, uint32_t period) {
+    uint32_t index;
+    if (freeHead != NONE) {
+        index = freeHead;
+        freeHead = nodes[index].next;
+    } else {
+        index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(Node());
+        nodes[index].generation = 1;
+    }
+
+    Node& node = nodes[index];
+    node.due = now + std::max(delay, 1u);
+    node.period = period;
+    node.entity = entity;
+    node.tag = tag;
+    node.data = data;
+    link(index);
+    pendingCount++;
+
+    return TimerHandle{index, node.generation};
+}
+
+bool TimerWheel::cancel(TimerHandle timer) {
+    if (!find(timer)) return false;
+
+    unlink(timer.index);
+    release(timer.index);
+    return true;
+}
+
+bool TimerWheel::isPending(TimerHandle timer) const {
+    return find(timer) != nullptr;
+}
+
+uint64_t TimerWheel::getRemaining(TimerHandle timer) const {
+    const Node* node = find(timer);
+    return node ? node->due - now : 0;
+}
+
+void TimerWheel::advance(uint32_t ticks, std::vector<Expiry>& expired) {
+    for (uint32_t t = 0; t < ticks; ++t) {
+        now++;
+
+        // Crossing into a new block of a coarser wheel: its timers for that
+        // block move down, coarsest first so they can keep falling
+        if ((now & (SLOTS - 1)) == 0) {
+            uint32_t top = 1;
+            while (top + 1 < LEVELS && (now & ((uint64_t(1) << (SLOT_BITS * (top + 1))) - 1)) == 0) {
+                top++;
+            }
+            for (uint32_t level = top; level >= 1; --level) {
+                cascade(level);
+            }
+        }
+
+        // Everything in the finest slot for this tick is due now
+        const uint32_t bucket = static_cast<uint32_t>(now & (SLOTS - 1));
+        uint32_t index = heads[bucket];
+        heads[bucket] = NONE;
+        tails[bucket] = NONE;
+
+        while (index != NONE) {
+            Node& node = nodes[index];
+            const uint32_t next = node.next;
+            expired.push_back({TimerHandle{index, node.generation}, node.entity, node.tag, node.data, now});
+
+            if (node.period > 0) {
+                node.due = now + node.period;
+                link(index);
+            } else {
+                release(index);
+            }
+            index = next;
+        }
+    }
+}
+
+void TimerWheel::reserve(size_t timerCount) {
+    nodes.reserve(timerCount);
+}
+
+void TimerWheel::clear() {
+    // Keep the pool and bump every live node's generation so old handles stay stale
+    for (uint32_t index = 0; index < nodes.size(); ++index) {
+        if (nodes[index].bucket != NO_BUCKET) {
+            release(index);
+        }
+    }
+    std::fill(std::begin(heads), std::end(heads), NONE);
+    std::fill(std::begin(tails), std::end(tails), NONE);
+    now = 0;
+    pendingCount = 0;
+}
+
+const TimerWheel::Node* TimerWheel::find(TimerHandle timer) const {
+    if (timer.index >= nodes.size()) return nullptr;
+
+    const Node& node = nodes[timer.index];
+    if (node.generation != timer.generation || node.bucket == NO_BUCKET) return nullptr;
+    return &node;
+}
+
+void TimerWheel::link(uint32_t index) {
+    Node& node = nodes[index];
+
+    // The coarsest digit where due and now differ picks the wheel; the slot is
+    // due's digit there. Timers due this very tick (while cascading) land in
+    // the finest slot about to fire.
+    const uint64_t differing = node.due ^ now;
+    uint32_t level = 0;
+    while (level + 1 < LEVELS && (differing >> (SLOT_BITS * (level + 1))) != 0) {
+        level++;
+    }
+    const uint32_t slot = static_cast<uint32_t>(node.due >> (SLOT_BITS * level)) & (SLOTS - 1);
+    const uint32_t bucket = level * SLOTS + slot;
+
+    node.bucket = static_cast<uint16_t>(bucket);
+    node.next = NONE;
+    node.prev = tails[bucket];
+    if (tails[bucket] != NONE) {
+        nodes[tails[bucket]].next = index;
+    } else {
+        heads[bucket] = index;
+    }
+    tails[bucket] = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes[index];
+    const uint32_t bucket = node.bucket;
+
+    if (node.prev != NONE) {
+        nodes[node.prev].next = node.next;
+    } else {
+        heads[bucket] = node.next;
+    }
+    if (node.next != NONE) {
+        nodes[node.next].prev = node.prev;
+    } else {
+        tails[bucket] = node.prev;
+    }
+    node.bucket = NO_BUCKET;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node& node = nodes[index];
+    node.bucket = NO_BUCKET;
+    node.generation = node.generation + 1 != 0 ? node.generation + 1 : 1;
+    node.next = freeHead;
+    freeHead = index;
+    pendingCount--;
+}
+
+void TimerWheel::cascade(uint32_t level) {
+    const uint32_t bucket = level * SLOTS + (static_cast<uint32_t>(now >> (SLOT_BITS * level)) & (SLOTS - 1));
+    uint32_t index = heads[bucket];
+    heads[bucket] = NONE;
+    tails[bucket] = NONE;
+
+    while (index != NONE) {
+        const uint32_t next = nodes[index].next;
+        link(index);
+        index = next;
+    }
+}